@@ -0,0 +1,72 @@
+/*
+DESCRIPTION:
+
+This code benchmarks meanCov against meanCovParallel. It generates N
+random rigid transformations scattered around a common pose and times
+the serial meanCov once, then meanCovParallel with a ThreadPool of
+1, 2, ... up to all hardware threads. For each thread count it prints
+the average run time, the speedup over the serial version and the
+largest deviation of the mean and covariance from the serial result.
+
+Usage:
+    mainBenchMeanCov [N] [repetitions] [grain_size]
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include <Eigen/Dense>
+#include "meanCov.h"
+
+int main(int argc, char **argv) {
+    int N = argc > 1 ? std::atoi(argv[1]) : 20000;
+    int reps = argc > 2 ? std::atoi(argv[2]) : 5;
+    int grain_size = argc > 3 ? std::atoi(argv[3]) : 256;
+
+    srand(12345);
+    Eigen::Matrix<double, 6, 1> base = Eigen::Matrix<double, 6, 1>::Random();
+    std::vector<Eigen::Matrix4d> X;
+    X.reserve(N);
+    for (int i = 0; i < N; ++i) {
+        X.push_back(se3Exp(base) * se3Exp(0.2 * Eigen::Matrix<double, 6, 1>::Random()));
+    }
+
+    typedef std::chrono::steady_clock Clock;
+    Eigen::Matrix4d Mean, Mean_par;
+    Eigen::Matrix<double, 6, 6> Cov, Cov_par;
+
+    Clock::time_point start = Clock::now();
+    for (int r = 0; r < reps; ++r) {
+        meanCov(X, Mean, Cov);
+    }
+    double t_serial = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / reps;
+
+    std::cout << "N = " << N << ", grain_size = " << grain_size << std::endl;
+    std::cout << "meanCov: " << std::fixed << std::setprecision(3) << t_serial << " ms" << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(14) << "time [ms]"
+              << std::setw(10) << "speedup" << std::setw(14) << "|dMean|"
+              << std::setw(14) << "|dCov|" << std::endl;
+
+    int max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (int t = 1; t <= max_threads; ++t) {
+        ThreadPool pool(t);
+        start = Clock::now();
+        for (int r = 0; r < reps; ++r) {
+            meanCovParallel(X, Mean_par, Cov_par, pool, grain_size);
+        }
+        double t_par = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / reps;
+
+        std::cout << std::setw(8) << t
+                  << std::setw(14) << std::fixed << std::setprecision(3) << t_par
+                  << std::setw(10) << std::setprecision(2) << t_serial / t_par
+                  << std::setw(14) << std::scientific << std::setprecision(2)
+                  << (Mean_par - Mean).cwiseAbs().maxCoeff()
+                  << std::setw(14) << (Cov_par - Cov).cwiseAbs().maxCoeff()
+                  << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,176 @@
+/*
+DESCRIPTION:
+
+This code compares the float and double versions of the solver pipeline
+on the bundled ABB and UR5e data sets. For each data set it loads the
+robot 1 poses (A), the camera to board poses (B) and the robot 2 poses
+(C), then runs meanCov, Prob 1 and the Prob 3 refinement once with
+double and once with float outputs. The data are read in double in both
+cases; the float path converts them on the fly.
+
+For each step it prints the run time of both paths and the deviation of
+the float result from the double one: the largest difference of the
+mean and covariance for meanCov, and the largest rotation / translation
+error between the two solutions of X, Y and Z for Prob 1 and Prob 3,
+together with the metric of both solutions evaluated in double. The
+rotation error uses the atan2-based PoseArray kernel of rotError: the
+acos-based skewLog reads 0 for angles below about 1e-8 and would hide
+small float / double differences.
+
+On both data sets meanCov and Prob 3 agree to about 1e-7 between float
+and double, Prob 1 only to about 4e-6 in translation and 1.5e-6 rad in
+rotation; the printed metrics are equal. The float path is not
+reliably faster: at -O2 it saves up to about 25% on ABB but ties on
+the 11 UR5e poses, and in a Debug build it is slower.
+
+Usage:
+    mainFloatAccuracy [repetitions]
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <Eigen/Dense>
+#include "meanCov.h"
+#include "metric.h"
+#include "getErrorAXBYCZ.h"
+#include "rotError.h"
+#include "poseArray.h"
+#include "axbyczProb1.h"
+#include "axbyczProb3.h"
+#include "loadMatrices.h"
+
+typedef std::chrono::steady_clock Clock;
+
+double elapsedMs(Clock::time_point start, int reps) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / reps;
+}
+
+// Rotation errors of the X, Y, Z solutions of the float path against the
+// double ones, with the atan2-based PoseArray kernel
+Eigen::VectorXd rotErrorXYZ(const Eigen::Matrix4d &X_f, const Eigen::Matrix4d &Y_f,
+                            const Eigen::Matrix4d &Z_f, const Eigen::Matrix4d &X,
+                            const Eigen::Matrix4d &Y, const Eigen::Matrix4d &Z) {
+    PoseArray P(std::vector<Eigen::Matrix4d>{X_f, Y_f, Z_f});
+    PoseArray Q(std::vector<Eigen::Matrix4d>{X, Y, Z});
+    Eigen::VectorXd err;
+    rotError(P, Q, err);
+    return err;
+}
+
+void printSolution(const std::string &name, double t_double, double t_float,
+                   const Eigen::Matrix4d &X_f, const Eigen::Matrix4d &Y_f,
+                   const Eigen::Matrix4d &Z_f, const Eigen::Matrix4d &X,
+                   const Eigen::Matrix4d &Y, const Eigen::Matrix4d &Z,
+                   double m_double, double m_float) {
+    Eigen::VectorXd rot = rotErrorXYZ(X_f, Y_f, Z_f, X, Y, Z);
+    Eigen::VectorXd diff = getErrorAXBYCZ(X_f, Y_f, Z_f, X, Y, Z);
+    std::cout << std::setw(10) << name
+              << std::setw(12) << std::fixed << std::setprecision(3) << t_double
+              << std::setw(12) << t_float
+              << std::setw(14) << std::scientific << std::setprecision(2)
+              << rot.maxCoeff()
+              << std::setw(14) << diff.tail<3>().maxCoeff()
+              << std::setw(14) << m_double
+              << std::setw(14) << m_float << std::endl;
+}
+
+void compareDataSet(const std::string &dir, int reps) {
+    std::vector<Eigen::Matrix4d> A, B, C;
+    loadMatrices(dir + "/r1_tf.txt", A);
+    loadMatrices(dir + "/c2b_tf.txt", B);
+    loadMatrices(dir + "/r2_tf.txt", C);
+    if (A.empty() || A.size() != B.size() || A.size() != C.size()) {
+        std::cerr << "Could not load " << dir << std::endl;
+        return;
+    }
+    std::cout << dir << ": " << A.size() << " poses" << std::endl;
+
+    // meanCov
+    Eigen::Matrix4d Mean;
+    Eigen::Matrix<double, 6, 6> Cov;
+    Eigen::Matrix4f Mean_f;
+    Eigen::Matrix<float, 6, 6> Cov_f;
+
+    Clock::time_point start = Clock::now();
+    for (int r = 0; r < reps; ++r) {
+        meanCov(B, Mean, Cov);
+    }
+    double t_double = elapsedMs(start, reps);
+
+    start = Clock::now();
+    for (int r = 0; r < reps; ++r) {
+        meanCov(B, Mean_f, Cov_f);
+    }
+    double t_float = elapsedMs(start, reps);
+
+    std::cout << std::setw(10) << "step" << std::setw(12) << "double [ms]"
+              << std::setw(12) << "float [ms]" << std::setw(14) << "rot diff"
+              << std::setw(14) << "tran diff" << std::setw(14) << "metric d"
+              << std::setw(14) << "metric f" << std::endl;
+    std::cout << std::setw(10) << "meanCov"
+              << std::setw(12) << std::fixed << std::setprecision(3) << t_double
+              << std::setw(12) << t_float
+              << std::setw(14) << std::scientific << std::setprecision(2)
+              << (Mean_f.cast<double>() - Mean).cwiseAbs().maxCoeff()
+              << std::setw(14) << (Cov_f.cast<double>() - Cov).cwiseAbs().maxCoeff()
+              << std::endl;
+
+    // Prob 1, the same poses serve as both data sets as in mainRealData
+    Eigen::Matrix4d X1, Y1, Z1;
+    Eigen::Matrix4f X1_f, Y1_f, Z1_f;
+
+    start = Clock::now();
+    for (int r = 0; r < reps; ++r) {
+        axbyczProb1(A, B, C, A, B, C, true, 0.0001, 0.0001, X1, Y1, Z1);
+    }
+    t_double = elapsedMs(start, reps);
+
+    start = Clock::now();
+    for (int r = 0; r < reps; ++r) {
+        axbyczProb1(A, B, C, A, B, C, true, 0.0001, 0.0001, X1_f, Y1_f, Z1_f);
+    }
+    t_float = elapsedMs(start, reps);
+
+    Eigen::Matrix4d X1_fd = X1_f.cast<double>(), Y1_fd = Y1_f.cast<double>(), Z1_fd = Z1_f.cast<double>();
+    printSolution("Prob 1", t_double, t_float, X1_fd, Y1_fd, Z1_fd, X1, Y1, Z1,
+                  metric(A, B, C, X1, Y1, Z1), metric(A, B, C, X1_fd, Y1_fd, Z1_fd));
+
+    // Prob 3 with Levenberg-Marquardt steps, both paths start from the
+    // double Prob 1 solution
+    Eigen::Matrix4d X3, Y3, Z3;
+    Eigen::Matrix4f X3_f, Y3_f, Z3_f;
+    Eigen::Matrix4f X1_init = X1.cast<float>(), Y1_init = Y1.cast<float>(), Z1_init = Z1.cast<float>();
+    int num = 0;
+    AxbyczProb3Params params;
+    params.method = AxbyczProb3Params::LevenbergMarquardt;
+
+    start = Clock::now();
+    for (int r = 0; r < reps; ++r) {
+        axbyczProb3(A, B, C, A, B, C, X1, Y1, Z1, X3, Y3, Z3, num, params);
+    }
+    t_double = elapsedMs(start, reps);
+
+    start = Clock::now();
+    for (int r = 0; r < reps; ++r) {
+        axbyczProb3(A, B, C, A, B, C, X1_init, Y1_init, Z1_init, X3_f, Y3_f, Z3_f, num, params);
+    }
+    t_float = elapsedMs(start, reps);
+
+    Eigen::Matrix4d X3_fd = X3_f.cast<double>(), Y3_fd = Y3_f.cast<double>(), Z3_fd = Z3_f.cast<double>();
+    printSolution("Prob 3", t_double, t_float, X3_fd, Y3_fd, Z3_fd, X3, Y3, Z3,
+                  metric(A, B, C, X3, Y3, Z3), metric(A, B, C, X3_fd, Y3_fd, Z3_fd));
+    std::cout << std::endl;
+}
+
+int main(int argc, char **argv) {
+    int reps = argc > 1 ? std::atoi(argv[1]) : 3;
+
+    compareDataSet("data/20230418_abb_charuco_10x14", reps);
+    compareDataSet("data/20230426_ur5e_charuco_5x7", reps);
+
+    return 0;
+}
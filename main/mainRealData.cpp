@@ -39,6 +39,7 @@ The script also defines some supporting functions that convert cell arrays to
  */
 
 #include <iostream>
+#include <cmath>
 #include <ctime>
 #include <vector>
 #include <Eigen/Dense>
@@ -47,6 +48,7 @@ The script also defines some supporting functions that convert cell arrays to
 #include "scrambleData.h"
 #include "axbyczProb1.h"
 #include "axbyczProb3.h"
+#include "axbyczMultiStart.h"
 #include "loadMatrices.h"
 #include "matplotlibcpp.h"
 
@@ -76,6 +78,10 @@ int main()
     std::cout << "A1[1]: " << A1[1] << std::endl;
 
     int init_guess = 3;
+
+    // Number of Prob 1 candidates refined concurrently when init_guess == 3,
+    // 1: refine only the best one
+    int num_starts = 1;
     Eigen::Matrix4d X_init, Y_init, Z_init;
     Eigen::Matrix4d X_cal1, Y_cal1, Z_cal1, X_cal2, Y_cal2, Z_cal2, X_cal3, Y_cal3, Z_cal3;
 
@@ -96,39 +102,45 @@ int main()
     }
 
     bool isRandPerm = true;
+    // Seed of the scramble streams, one stream per rate and data set
+    uint64_t seed = 2023;
+
+    // Views of the data sets that are never scrambled
+    PermutedPoses<> A1v(A1), C1v(C1), A2v(A2), C2v(C2);
 
     // Choice of scramble rate
     std::vector<int> r = {0, 10, 20, 30, 40, 50, 60, 70, 80, 90, 100};
     std::vector<double> err1(11), err3(11);
-    for (int rk = 0; rk < r.size(); ++rk) {
-        // Inputs for Prob 1
-        std::vector<Eigen::Matrix4d> Bp1(A1.size());
-        std::vector<Eigen::Matrix4d> Bp2(A2.size());
-        std::vector<Eigen::Matrix4d> BBp1(A1.size());
-        std::vector<Eigen::Matrix4d> BBp2(A2.size());
-
-        for (int i = 0; i < A1.size(); ++i) {
-            // Inputs for Iterative Refinement
-            if (isRandPerm) {
-                Bp1[i] = scrambleData(B1, i, r[rk])[i];
-                Bp2[i] = scrambleData(B2, i, r[rk])[i];
-                BBp1[i] = scrambleData(B1, i, r[rk])[i];
-                BBp2[i] = scrambleData(B2, i, r[rk])[i];
-            } else {
-                Bp1[i] = B1[i];
-                Bp2[i] = B2[i];
-                BBp1[i] = B1[i];
-                BBp2[i] = B2[i];
-            }
-
+    for (size_t rk = 0; rk < r.size(); ++rk) {
+        RngStream rng_p1(seed, 0, rngStreamId(RngPurpose::Scramble, rk, 0));
+        RngStream rng_p2(seed, 0, rngStreamId(RngPurpose::Scramble, rk, 1));
+        RngStream rng_pp1(seed, 0, rngStreamId(RngPurpose::Scramble, rk, 2));
+        RngStream rng_pp2(seed, 0, rngStreamId(RngPurpose::Scramble, rk, 3));
+
+        // One permutation per data set and rate, as views of B1 and B2.
+        // Bp for the iterative refinement, BBp for Prob 1.
+        PermutedPoses<> Bp1(B1), Bp2(B2), BBp1(B1), BBp2(B2);
+        if (isRandPerm) {
+            Bp1 = scrambleView(B1, r[rk], rng_p1);
+            Bp2 = scrambleView(B2, r[rk], rng_p2);
+            BBp1 = scrambleView(B1, r[rk], rng_pp1);
+            BBp2 = scrambleView(B2, r[rk], rng_pp2);
         }
 
         // Prob 1
         //std::cout << "Probabilistic Method 1..." << std::endl;
-        axbyczProb1(A1, BBp1, C1,
-                    A2, BBp2, C2,
-                    1, 0.0001, 0.0001,
-                    X_cal1, Y_cal1, Z_cal1);
+        std::vector<XYZCandidate> candidates;
+        if (axbyczProb1(A1v, BBp1, C1v,
+                        A2v, BBp2, C2v,
+                        1, 0.0001, 0.0001,
+                        num_starts, candidates) == 0) {
+            std::cerr << "Prob 1 found no solution at scramble rate " << r[rk] << std::endl;
+            err1[rk] = err3[rk] = std::nan("");
+            continue;
+        }
+        X_cal1 = candidates[0].X;
+        Y_cal1 = candidates[0].Y;
+        Z_cal1 = candidates[0].Z;
 
         // Initial guess for iterative refinement as the results from prob 1
         if (init_guess == 3) {
@@ -141,11 +153,19 @@ int main()
         //std::cout << "Iterative Refinement..." << std::endl;
         int num = 1;
 
-        axbyczProb3(A1, Bp1, C1,
-                    A2, Bp2, C2,
-                    X_init, Y_init, Z_init,
-                    X_cal3, Y_cal3, Z_cal3 ,
-                    num);
+        if (init_guess == 3 && num_starts > 1) {
+            ThreadPool pool;
+            std::vector<MultiStartResult> starts;
+            int k_best = axbyczMultiStart(candidates, A1v, Bp1, C1v, A2v, Bp2, C2v, pool,
+                                          X_cal3, Y_cal3, Z_cal3, starts);
+            num = starts[k_best].num;
+        } else {
+            axbyczProb3(A1v, Bp1, C1v,
+                        A2v, Bp2, C2v,
+                        X_init, Y_init, Z_init,
+                        X_cal3, Y_cal3, Z_cal3 ,
+                        num);
+        }
 
         // Verification
         // Prob 1
@@ -199,7 +219,7 @@ int main()
     plt::show();
 
     std::cout << "Error 1 [0]: " << err1[0] << std::endl;
-    std::cout << "Error 1 [10]: " << err1[100] << std::endl;
+    std::cout << "Error 1 [10]: " << err1[10] << std::endl;
     std::cout << "Error 3 [0]: " << err3[0] << std::endl;
-    std::cout << "Error 3 [10]: " << err3[100] << std::endl;
+    std::cout << "Error 3 [10]: " << err3[10] << std::endl;
 }
\ No newline at end of file
@@ -13,6 +13,25 @@ The script generates data by setting initial guesses for X, Y, and Z to
  scrambleData function. The inputs for Prob 1 are then set and the script
  displays that it is running Probabilistic Method 1.
 
+ The (trial, scramble rate) experiments are independent and run in
+ parallel with monteCarloSweep, which reports the progress and the number
+ of experiments per second. Each experiment draws its random numbers from
+ its own streams of the seed, so the results do not depend on the number
+ of threads.
+
+ The number of trials of each scramble rate is adaptive: adaptiveSweep
+ keeps running trials of a rate until the 95 % confidence intervals of
+ the getErrorAXBYCZ errors of Prob 1 and of the iterative refinement have
+ a half-width below 0.005 or 10 % of their means, or until max_trials.
+ Quiet rates stop after a few trials and the noisy ones get the remaining
+ compute.
+
+ Every finished experiment is appended to a checkpoint file. When the
+ program is restarted with the same seed and settings, the experiments
+ found in the file are read back instead of being run again.
+
+ Usage:
+     mainSimulation [seed] [threads] [checkpoint]
 */
 
 /*
@@ -20,6 +39,9 @@ The script generates data by setting initial guesses for X, Y, and Z to
  */
 
 #include <iostream>
+#include <cstdlib>
+#include <string>
+#include <thread>
 #include <vector>
 #include <Eigen/Dense>
 #include "initializeXYZ.h"
@@ -29,153 +51,154 @@ The script generates data by setting initial guesses for X, Y, and Z to
 #include "metric.h"
 #include "axbyczProb1.h"
 #include "axbyczProb3.h"
+#include "adaptiveSweep.h"
+#include "sweepCheckpoint.h"
 #include "matplotlibcpp.h"
 
 namespace plt = matplotlibcpp;
 
-int main() {
-    int init_guess = 2;
-    Eigen::Matrix4d X_init, Y_init, Z_init;
+int main(int argc, char **argv) {
+    uint64_t seed = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1;
+    int num_threads = argc > 2 ? std::atoi(argv[2]) : std::thread::hardware_concurrency();
+    std::string checkpoint_path = argc > 3 ? argv[3] : "results/mainSimulation.ckpt";
 
-    if (init_guess == 1) {
-        X_init.setIdentity();
-        Y_init.setIdentity();
-        Z_init.setIdentity();
-    }
+    int init_guess = 2;
 
     bool isRandPerm = true;
     std::vector<int> r = {0, 10, 20, 30, 40, 50, 60, 70, 80, 90, 100};
-    int num_trials = 20;
-
-    Eigen::VectorXd err_prob, err_iter;
-    double err1, err2;
-    //Eigen::MatrixXd err1_mat, err2_mat;
-    Eigen::MatrixXd err1_mat = Eigen::MatrixXd::Zero(r.size(), num_trials);
-    Eigen::MatrixXd err2_mat = Eigen::MatrixXd::Zero(r.size(), num_trials);
-
-    for (int n = 0; n < num_trials; ++n) {
+    AdaptiveSweepParams params;
+    params.min_trials = 5;
+    params.max_trials = 40;
+    params.abs_tol = 0.005;
+    params.rel_tol = 0.1;
+    params.tracked = {2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13};
+    int length = 100;
+    double cov_coeff = 0.1;
+
+    // Returns err1, err2, the Prob 1 errors and the iterative errors
+    auto experiment = [&](const SweepCell &cell) {
+        int rk = cell.rate;
+
+        // Same ground truth for all rates of a trial
         Eigen::Matrix4d X_true, Y_true, Z_true;
-        initializeXYZ(1, X_true, Y_true, Z_true);
-
-        for (int rk = 0; rk < r.size(); ++rk) {
-            int length = 100;
-            Eigen::VectorXd Mean = Eigen::VectorXd::Zero(6);
-            Eigen::MatrixXd Cov = 0.1 * Eigen::MatrixXd::Identity(6, 6);
-
-            std::vector<Eigen::Matrix4d> A, B, C, Bp;
-
-            std::vector<Eigen::Matrix4d> A1, B1, C1, A2, B2, C2;
-
-            for (int i = 0; i < 5; ++i) {
-                std::tie(A1, B1, C1) = generateABC(length, 1, 1, Mean, Cov,
-                                                   X_true, Y_true, Z_true);
-                std::tie(A2, B2, C2) = generateABC(length, 3, 1, Mean, Cov,
-                                                   X_true, Y_true, Z_true);
-
-                A.insert(A.end(), A1.begin(), A1.end());
-                A.insert(A.end(), A2.begin(), A2.end());
-
-                B.insert(B.end(), B1.begin(), B1.end());
-                B.insert(B.end(), B2.begin(), B2.end());
-
-                C.insert(C.end(), C1.begin(), C1.end());
-                C.insert(C.end(), C2.begin(), C2.end());
-
-                if (isRandPerm) {
-                    Bp.emplace_back(scrambleData(B1[i], r[rk]));
-                    Bp.emplace_back(scrambleData(B2[i], r[rk]));
-                }
-            }
-
-            // Inputs for Prob 1
-            Eigen::Matrix4d AA1 = A1[0];
-            Eigen::Matrix4d BB1 = B1[0];
-            Eigen::Matrix4d CC1 = C1[0];
-            Eigen::Matrix4d AA2 = A2[0];
-            Eigen::Matrix4d BB2 = B2[0];
-            Eigen::Matrix4d CC2 = C2[0];
-            Eigen::MatrixXd BBp1, BBp2;
-
-            if (isRandPerm) {
-                BBp1 = scrambleData(BB1, r[rk]);
-                BBp2 = scrambleData(BB2, r[rk]);
-                Bp.emplace_back(scrambleData(BB1, r[rk]));
-            }
-
-            // Prob 1
-            Eigen::Matrix4d X_cal1, Y_cal1, Z_cal1;
-
-            axbyczProb1(AA1, BBp1, CC1, AA2, BBp2, CC2,
-                        true, 0.001, 0.001,
-                        X_cal1, Y_cal1, Z_cal1);
-
-            if (init_guess == 2) {
-                X_init = X_cal1;
-                Y_init = Y_cal1;
-                Z_init = Z_cal1;
-            }
-
-
-            Eigen::Matrix4d X_cal2, Y_cal2, Z_cal2;
-            int num2;
-
-            axbyczProb3(A1, B1, C1, A2, B2, C2,
-                        X_init, Y_init, Z_init,
-                        X_cal2, Y_cal2, Z_cal2, num2);
-
-            // Verification
-            // Prob 1
-            err_prob = getErrorAXBYCZ(X_cal1, Y_cal1, Z_cal1,
-                                      X_true, Y_true, Z_true);
-            err1 = metric(A1, B1, C1, X_cal1, Y_cal1, Z_cal1)
-                   + metric(A2, B2, C2, X_cal1, Y_cal1, Z_cal1);
-            err1_mat.coeffRef(rk, n) = err1;
-
-            // Iterative refinement
-            err_iter = getErrorAXBYCZ(X_cal2, Y_cal2, Z_cal2,
-                                      X_true, Y_true, Z_true);
-            err2 = metric(A1, B1, C1, X_cal2, Y_cal2, Z_cal2)
-                   + metric(A2, B2, C2, X_cal2, Y_cal2, Z_cal2);
-            err2_mat.coeffRef(rk, n) = err2;
+        RngStream rng_xyz = cell.trialStream(RngPurpose::GroundTruth);
+        initializeXYZ(1, X_true, Y_true, Z_true, rng_xyz);
+
+        Eigen::VectorXd Mean = Eigen::VectorXd::Zero(6);
+        Eigen::MatrixXd Cov = cov_coeff * Eigen::MatrixXd::Identity(6, 6);
+
+        // A1 fixed with B1, C1 free, C2 fixed with A2, B2 free
+        std::vector<Eigen::Matrix4d> A1, B1, C1, A2, B2, C2;
+        RngStream rng_1 = cell.stream(RngPurpose::Data, 1);
+        RngStream rng_2 = cell.stream(RngPurpose::Data, 2);
+        std::tie(A1, B1, C1) = generateABC(length, 1, 1, Mean, Cov,
+                                           X_true, Y_true, Z_true, rng_1);
+        std::tie(A2, B2, C2) = generateABC(length, 3, 1, Mean, Cov,
+                                           X_true, Y_true, Z_true, rng_2);
+
+        PermutedPoses<> A1v(A1), C1v(C1), A2v(A2), C2v(C2), Bp1(B1), Bp2(B2);
+        if (isRandPerm) {
+            RngStream rng_p1 = cell.stream(RngPurpose::Scramble, 1);
+            RngStream rng_p2 = cell.stream(RngPurpose::Scramble, 2);
+            Bp1 = scrambleView(B1, r[rk], rng_p1);
+            Bp2 = scrambleView(B2, r[rk], rng_p2);
         }
-    }
 
-    // Compute the averaged errors
-    Eigen::MatrixXd err_prob_avg = err_prob.colwise().sum() / num_trials;
-    Eigen::MatrixXd err_iter_avg = err_iter.colwise().sum() / num_trials;
-
-    Eigen::VectorXd err1_avg = err1_mat.rowwise().sum() / num_trials;
-    Eigen::VectorXd err2_avg = err2_mat.rowwise().sum() / num_trials;
-
-    std::cout << "works till here? - YES" << std::endl;
+        // Prob 1
+        // Without a solution, Prob 1 and the refinement start from identity
+        Eigen::Matrix4d X_cal1, Y_cal1, Z_cal1;
+        X_cal1.setIdentity();
+        Y_cal1.setIdentity();
+        Z_cal1.setIdentity();
+        axbyczProb1(A1v, Bp1, C1v, A2v, Bp2, C2v,
+                    true, 0.001, 0.001,
+                    X_cal1, Y_cal1, Z_cal1);
+
+        Eigen::Matrix4d X_init, Y_init, Z_init;
+        if (init_guess == 1) {
+            X_init.setIdentity();
+            Y_init.setIdentity();
+            Z_init.setIdentity();
+        } else {
+            X_init = X_cal1;
+            Y_init = Y_cal1;
+            Z_init = Z_cal1;
+        }
 
-    std::cout << "err1_avg: " << err1_avg << std::endl;
-    std::cout << "err2_avg: " << err2_avg << std::endl;
+        // Iterative refinement
+        Eigen::Matrix4d X_cal2, Y_cal2, Z_cal2;
+        int num2 = 0;
+        axbyczProb3(A1v, Bp1, C1v, A2v, Bp2, C2v,
+                    X_init, Y_init, Z_init,
+                    X_cal2, Y_cal2, Z_cal2, num2);
+
+        // Verification
+        std::vector<double> values(14);
+        Eigen::Map<Eigen::VectorXd> v(values.data(), values.size());
+
+        // Prob 1
+        v(0) = metric(A1, B1, C1, X_cal1, Y_cal1, Z_cal1)
+               + metric(A2, B2, C2, X_cal1, Y_cal1, Z_cal1);
+        v.segment<6>(2) = getErrorAXBYCZ(X_cal1, Y_cal1, Z_cal1,
+                                         X_true, Y_true, Z_true);
+
+        // Iterative refinement
+        v(1) = metric(A1, B1, C1, X_cal2, Y_cal2, Z_cal2)
+               + metric(A2, B2, C2, X_cal2, Y_cal2, Z_cal2);
+        v.segment<6>(8) = getErrorAXBYCZ(X_cal2, Y_cal2, Z_cal2,
+                                         X_true, Y_true, Z_true);
+        return values;
+    };
+
+    // Settings that change the result of an experiment, the number of
+    // trials is left out so that a sweep can be extended
+    ConfigHash config;
+    config.add(std::string("mainSimulation")).add(r).add(length).add(cov_coeff)
+          .add(init_guess).add(static_cast<int>(isRandPerm));
+    SweepCheckpoint checkpoint(checkpoint_path, config.value(), seed);
+
+    ThreadPool pool(num_threads);
+    std::cout << "Running " << params.min_trials << " to " << params.max_trials << " trials x "
+              << r.size() << " scramble rates on " << pool.size() << " threads, seed " << seed << std::endl;
+    std::vector<RunningStats> stats = adaptiveSweep(pool, checkpoint, r.size(), experiment, params);
+
+    // Averaged errors and number of trials of each rate
+    Eigen::MatrixXd err_prob_avg(r.size(), 6), err_iter_avg(r.size(), 6);
+    Eigen::VectorXd err1_avg(r.size()), err2_avg(r.size());
+    Eigen::VectorXi num_trials(r.size());
+    int total_trials = 0;
+    for (size_t rk = 0; rk < r.size(); ++rk) {
+        err1_avg(rk) = stats[rk].mean()(0);
+        err2_avg(rk) = stats[rk].mean()(1);
+        err_prob_avg.row(rk) = stats[rk].mean().segment<6>(2).transpose();
+        err_iter_avg.row(rk) = stats[rk].mean().segment<6>(8).transpose();
+        num_trials(rk) = stats[rk].count();
+        total_trials += stats[rk].count();
+    }
 
-    std::cout << "works till here?" << std::endl;
+    std::cout << "trials: " << num_trials.transpose() << " (" << total_trials << " of "
+              << params.max_trials * r.size() << ")" << std::endl;
+    std::cout << "err1_avg: " << err1_avg.transpose() << std::endl;
+    std::cout << "err2_avg: " << err2_avg.transpose() << std::endl;
 
     ///// PLOTS
 
     // Plot error v.s. scramble rate
     // Errors with ground truth
     plt::figure();
-    int fontSize = 20;
-    int lineW = 1;
     std::vector<std::string> y_lb = {"$R_{X}$", "$R_{Y}$", "$R_{Z}$",
                                      "${\\bf t_{X}}$", "${\\bf t_{Y}}$", "${\\bf t_{Z}}$"};
 
-    auto x_data = Eigen::Map<const Eigen::VectorXd>(reinterpret_cast<const double *>(r.data()), r.size());
+    std::vector<double> r_vec(r.begin(), r.end());
 
     for (int i = 0; i < 6; ++i) { //
 
         plt::subplot(2, 3, i+1);
 
         // Plot data
-        auto y_data = err_prob_avg.col(i).cast<double>();
-        std::vector<double> x_data_vec(x_data.data(), x_data.data() + x_data.size());
+        Eigen::VectorXd y_data = err_prob_avg.col(i);
         std::vector<double> y_data_vec(y_data.data(), y_data.data() + y_data.size());
-        std::cout << "Size of x_data_vec: " << x_data_vec.size() << ", Size of y_data_vec: " << y_data_vec.size() << std::endl;
-        plt::plot(x_data_vec, y_data_vec, "o-r");
+        plt::plot(r_vec, y_data_vec, "o-r");
 
         // Set axis labels
         plt::xlabel("Scramble Rate / %");
@@ -187,7 +210,6 @@ int main() {
 
     // Errors between two sides of calibration equations
     plt::figure();
-    std::vector<double> r_vec(r.begin(), r.end());
     std::vector<double> err1_avg_vec(err1_avg.data(), err1_avg.data() + err1_avg.size());
     std::vector<double> err2_avg_vec(err2_avg.data(), err2_avg.data() + err2_avg.size());
     plt::plot(r_vec, err1_avg_vec, "o-r");
@@ -0,0 +1,172 @@
+/*
+DESCRIPTION:
+
+The program refines several initial guesses for AXB = YCZ at once. When
+the probabilistic cost of axbyczProb1 is ambiguous, e.g. at high scramble
+rates, its single best (X, Y, Z) combination may lead axbyczProb3 into a
+poor local minimum. axbyczMultiStart takes the best Prob1 combinations
+(see the num_candidates overload of axbyczProb1), runs axbyczProb3 from
+each of them as a task on a ThreadPool, and returns the refined solution
+with the lowest metric over all data.
+
+The mean and covariance of every cluster are computed once and shared
+by all starts. The starts also share the lowest cost reported by any of
+them so far: the metric, or with params.metric_every != 1 the root mean
+square residual of axbyczProb3, so all starts compare the same kind of
+cost. After min_num iterations, a start whose cost exceeds cancel_ratio
+times this best cost is stopped early and marked as cancelled. The
+starts are submitted in the order of their Prob1 cost, so with fewer
+threads than starts the most promising ones run first. Which starts are
+cancelled depends on the thread timing; cancel_ratio <= 0 disables
+cancellation and makes the result deterministic.
+
+Input:
+    starts: Prob1 candidates, ordered by cost
+    A1, B1, C1, A2, B2, C2: calibration data as in axbyczProb3, clusters
+                            as vectors of Matrix4d, CompactPoses or
+                            PermutedPoses views
+    pool: thread pool running the starts
+    params: settings of each refinement
+    cancel_ratio, min_num: early cancellation of clearly worse starts
+Output:
+    X_cal, Y_cal, Z_cal: Matrices - dim 4x4, best refined solution
+    results: per-start statistics, in the order of starts
+    returns the index of the best start
+*/
+
+#ifndef AXBYCZMULTISTART_H
+#define AXBYCZMULTISTART_H
+
+#include <atomic>
+#include <future>
+#include <limits>
+#include <vector>
+#include <Eigen/Dense>
+#include "threadPool.h"
+#include "axbyczProb1.h"
+#include "axbyczProb3.h"
+
+struct MultiStartResult {
+    Eigen::Matrix4d X, Y, Z;  // refined solution
+    double prob1_cost;        // cost of the start in axbyczProb1
+    double cost;              // metric of the refined solution over all data
+    int num;                  // iterations of axbyczProb3
+    bool cancelled;           // stopped early as clearly worse than the best
+};
+
+template <typename Sequence>
+int axbyczMultiStart(const std::vector<XYZCandidate> &starts,
+                     const std::vector<Sequence> &A1,
+                     const std::vector<Sequence> &B1,
+                     const std::vector<Sequence> &C1,
+                     const std::vector<Sequence> &A2,
+                     const std::vector<Sequence> &B2,
+                     const std::vector<Sequence> &C2,
+                     ThreadPool &pool,
+                     Eigen::Matrix4d &X_cal,
+                     Eigen::Matrix4d &Y_cal,
+                     Eigen::Matrix4d &Z_cal,
+                     std::vector<MultiStartResult> &results,
+                     const AxbyczProb3Params &params = AxbyczProb3Params(),
+                     double cancel_ratio = 10.0,
+                     int min_num = 3) {
+    int K = starts.size();
+    results.assign(K, MultiStartResult());
+
+    // Cluster statistics and PoseArray copies, shared by all starts
+    AxbyczProb3Stats<double> stats(A1, B1, C1, A2, B2, C2);
+    std::atomic<double> best(std::numeric_limits<double>::infinity());
+
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(K);
+    for (int k = 0; k < K; ++k) {
+        tasks.push_back(pool.submit([&, k] {
+            MultiStartResult &r = results[k];
+            r.prob1_cost = starts[k].cost;
+            r.cancelled = false;
+            r.num = 0;
+
+            AxbyczProb3Params start_params = params;
+            start_params.keep_going = [&](int num, double diff) {
+                if (params.keep_going && !params.keep_going(num, diff)) {
+                    return false;
+                }
+                double b = best.load();
+                while (diff < b && !best.compare_exchange_weak(b, diff)) {
+                }
+                if (cancel_ratio > 0 && num >= min_num && diff > cancel_ratio * std::min(b, diff)) {
+                    r.cancelled = true;
+                    return false;
+                }
+                return true;
+            };
+
+            axbyczProb3(stats, starts[k].X, starts[k].Y, starts[k].Z,
+                        r.X, r.Y, r.Z, r.num, start_params, nullptr, nullptr, &r.cost);
+        }));
+    }
+    for (auto &task : tasks) {
+        task.get();
+    }
+
+    // Best refined solution, cancelled starts included
+    int k_best = -1;
+    for (int k = 0; k < K; ++k) {
+        if (k_best < 0 || results[k].cost < results[k_best].cost) {
+            k_best = k;
+        }
+    }
+    if (k_best >= 0) {
+        X_cal = results[k_best].X;
+        Y_cal = results[k_best].Y;
+        Z_cal = results[k_best].Z;
+    }
+    return k_best;
+}
+
+// Data recorded at a single fixed A pose and a single fixed C pose
+int axbyczMultiStart(const std::vector<XYZCandidate> &starts,
+                     const std::vector<Eigen::Matrix4d> &A1,
+                     const std::vector<Eigen::Matrix4d> &B1,
+                     const std::vector<Eigen::Matrix4d> &C1,
+                     const std::vector<Eigen::Matrix4d> &A2,
+                     const std::vector<Eigen::Matrix4d> &B2,
+                     const std::vector<Eigen::Matrix4d> &C2,
+                     ThreadPool &pool,
+                     Eigen::Matrix4d &X_cal,
+                     Eigen::Matrix4d &Y_cal,
+                     Eigen::Matrix4d &Z_cal,
+                     std::vector<MultiStartResult> &results,
+                     const AxbyczProb3Params &params = AxbyczProb3Params(),
+                     double cancel_ratio = 10.0,
+                     int min_num = 3) {
+    typedef std::vector<std::vector<Eigen::Matrix4d>> Clusters;
+    return axbyczMultiStart(starts, Clusters(1, A1), Clusters(1, B1), Clusters(1, C1),
+                            Clusters(1, A2), Clusters(1, B2), Clusters(1, C2),
+                            pool, X_cal, Y_cal, Z_cal, results, params, cancel_ratio, min_num);
+}
+
+// Same, with the data given as single views
+template <typename Base>
+int axbyczMultiStart(const std::vector<XYZCandidate> &starts,
+                     const PermutedPoses<Base> &A1,
+                     const PermutedPoses<Base> &B1,
+                     const PermutedPoses<Base> &C1,
+                     const PermutedPoses<Base> &A2,
+                     const PermutedPoses<Base> &B2,
+                     const PermutedPoses<Base> &C2,
+                     ThreadPool &pool,
+                     Eigen::Matrix4d &X_cal,
+                     Eigen::Matrix4d &Y_cal,
+                     Eigen::Matrix4d &Z_cal,
+                     std::vector<MultiStartResult> &results,
+                     const AxbyczProb3Params &params = AxbyczProb3Params(),
+                     double cancel_ratio = 10.0,
+                     int min_num = 3) {
+    typedef std::vector<PermutedPoses<Base>> Clusters;
+    return axbyczMultiStart(starts, Clusters(1, A1), Clusters(1, B1), Clusters(1, C1),
+                            Clusters(1, A2), Clusters(1, B2), Clusters(1, C2),
+                            pool, X_cal, Y_cal, Z_cal, results, params, cancel_ratio, min_num);
+}
+
+#endif
@@ -16,6 +16,18 @@ Input:
     nstd1, nst2: standard deviation
 Output:
     X_final, Y_final, Z_final: Matrices - dim 4x4
+    or candidates: the num_candidates combinations with the smallest cost
+    returns whether a solution was found, or the number of candidates;
+    X_final, Y_final, Z_final are left unchanged without a solution
+
+Every pair of X and Z candidates yields two Y candidates, one through
+each fixed pose. Only these consistent (X, Y, Z) combinations are
+scored, and the best ones are kept while streaming over them. The
+search is done by axbyczProbN with an A-fixed and a C-fixed group.
+The data may be given as vectors of Matrix4d, as CompactPoses or as
+PermutedPoses views. The
+solver runs in the scalar type of X_final, Y_final and Z_final (or of
+the candidates), so Matrix4f outputs select the float path.
 
 In the case of two robotic arms:
      A - robot 1's base to end effector transformation (forward kinematics)
@@ -32,123 +44,55 @@ In the case of two robotic arms:
 
 #include <iostream>
 #include <vector>
-#include <cmath>
-#include <limits>
 #include <eigen3/Eigen/Dense>
-#include "batchSolveXY.h"
-#include "rotError.h"
-#include "tranError.h"
+#include "axbyczProbN.h"
+
+template <typename Sequence, typename Scalar>
+int axbyczProb1(const Sequence& A1,
+                const Sequence& B1,
+                const Sequence& C1,
+                const Sequence& A2,
+                const Sequence& B2,
+                const Sequence& C2,
+                bool opt,
+                double nstd1,
+                double nstd2,
+                int num_candidates,
+                std::vector<XYZCandidateT<Scalar>>& candidates){
+
+    //// A1 is constant with B1 and C1 free, C2 is constant with A2 and B2 free
+    std::vector<FixtureGroupT<Scalar>> groups = {
+            FixtureGroupT<Scalar>(FixedPose::A, A1, B1, C1),
+            FixtureGroupT<Scalar>(FixedPose::C, A2, B2, C2)};
 
-void axbyczProb1(const std::vector<Eigen::Matrix4d>& A1,
-                 const std::vector<Eigen::Matrix4d>& B1,
-                 const std::vector<Eigen::Matrix4d>& C1,
-                 const std::vector<Eigen::Matrix4d>& A2,
-                 const std::vector<Eigen::Matrix4d>& B2,
-                 const std::vector<Eigen::Matrix4d>& C2,
+    double weight = 1.5;
+    return axbyczProbN(groups, opt, nstd1, nstd2, weight, num_candidates, candidates);
+}
+
+template <typename Sequence, typename Scalar>
+bool axbyczProb1(const Sequence& A1,
+                 const Sequence& B1,
+                 const Sequence& C1,
+                 const Sequence& A2,
+                 const Sequence& B2,
+                 const Sequence& C2,
                  bool opt,
                  double nstd1,
                  double nstd2,
-                 Eigen::Matrix4d& X_final,
-                 Eigen::Matrix4d& Y_final,
-                 Eigen::Matrix4d& Z_final){
-
-    //// A1 is constant with B1 and C1 free
-    Eigen::Matrix4d A1_fixed = A1[0];
-
-    //// C2 is constant with A2 and B2 free
-    Eigen::Matrix4d C2_fixed = C2[0];
-
-    //// Solve for Z
-    std::vector<Eigen::Matrix4d> Z_g, X_dummy, Y_dummy;
-    Eigen::Matrix4d MeanC1, MeanB1, MeanA2, MeanB2, MeanA2_inv, MeanB2_inv;
-    Eigen::Matrix<double, 6, 6> SigC1, SigB1, SigA2, SigB2;
-
-    batchSolveXY(C1, B1, opt, nstd1, nstd2, Z_g, Y_dummy,
-                 MeanC1, MeanB1, SigC1, SigB1);
-
-    std::vector<Eigen::Matrix4d> Z;
-    for (const auto& z : Z_g) {
-        if (z.determinant() > 0) {
-            Z.push_back(z);
-        }
-    }
-
-    int s_Z = Z.size();
-
-    // Calculate B2_inv
-    int Num = A2.size();
-    std::vector<Eigen::Matrix4d> A2_inv(Num), B2_inv(Num);
-    for (int i = 0; i < Num; ++i) {
-        A2_inv[i] = A2[i].inverse();
-        B2_inv[i] = B2[i].inverse();
-    }
-
-    //// Solve for X
-    std::vector<Eigen::Matrix4d> X_g;
-    batchSolveXY(A2, B2_inv, opt, nstd1, nstd2, X_g, Y_dummy,
-                 MeanA2, MeanB2_inv, SigA2, SigB2);
-
-    std::vector<Eigen::Matrix4d> X;
-    for (const auto& x : X_g) {
-        if (x.determinant() > 0) {
-            X.push_back(x);
-        }
-    }
-
-    size_t s_X = X.size();
-
-    // Calculate MeanB2 for computing Y later
-    batchSolveXY(A2_inv, B2, opt, nstd1, nstd2, X_dummy, Y_dummy,
-                 MeanA2_inv, MeanB2, SigA2, SigB2);
-
-    // Solve for Y
-    std::vector<Eigen::Matrix4d> Y(2 * s_X * s_Z);
-    for (int i = 0; i < s_X; ++i) {
-        for (int j = 0; j < s_Z; ++j) {
-            Y[(i * s_Z) + j] = (A1_fixed * X[i] * MeanB1 * Z[j].inverse()) * MeanC1.inverse(); // ignore element wise multiplication form in MATLAB version
-            Y[(i * s_Z) + j + s_X * s_Z] = (MeanA2 * X[i] * MeanB2 * Z[j].inverse()) * C2_fixed.inverse();
-        }
-    }
-
-    int s_Y = Y.size();
-
-    // Find the optimal (X, Y, Z) that minimizes cost
-    Eigen::MatrixXd cost(s_X, s_Y * s_Z);
-    double weight = 1.5;
-    double min_cost = std::numeric_limits<double>::max();
-    int min_i = 0, min_j = 0, min_m = 0;
-
-    for (size_t i = 0; i < s_X; ++i) {
-        for (size_t j = 0; j < s_Z; ++j) {
-            for (size_t m = 0; m < s_Y; ++m) {
-                Eigen::Matrix4d left1 = A1_fixed * X[i] * MeanB1;
-                Eigen::Matrix4d right1 = Y[m] * MeanC1 * Z[j];
-
-                double diff1 = rotError(left1, right1) + weight *
-                                                         tranError(left1, right1);
-
-                Eigen::Matrix4d left2 = MeanA2 * X[i] * MeanB2;
-                Eigen::Matrix4d right2 = Y[m] * C2_fixed * Z[j];
-
-                double diff2 = rotError(left2, right2) + weight *
-                                                         tranError(left2, right2);
+                 Eigen::Matrix<Scalar, 4, 4>& X_final,
+                 Eigen::Matrix<Scalar, 4, 4>& Y_final,
+                 Eigen::Matrix<Scalar, 4, 4>& Z_final){
 
-                double current_cost = std::abs(diff1) + std::abs(diff2);
-                cost(i, j * s_Y + m) = current_cost;
-                if (current_cost < min_cost) {
-                    min_cost = current_cost;
-                    min_i = i;
-                    min_j = j;
-                    min_m = m;
-                }
-            }
-        }
+    std::vector<XYZCandidateT<Scalar>> best;
+    if (axbyczProb1(A1, B1, C1, A2, B2, C2, opt, nstd1, nstd2, 1, best) == 0) {
+        return false;
     }
 
     //// Recover the X, Y, Z that minimize cost
-    X_final = X[min_i];
-    Z_final = Z[min_j];
-    Y_final = Y[min_m];
+    X_final = best[0].X;
+    Y_final = best[0].Y;
+    Z_final = best[0].Z;
+    return true;
 }
 
 #endif
\ No newline at end of file
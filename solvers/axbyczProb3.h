@@ -23,9 +23,47 @@ DESCRIPTION:
  Inputs:
    A1,B1,C1: Cell arrays, which stores when fixing A1 at different poses;
    A2,B2,C2: Cell arrays, which stores when fixing C2 at different poses;
+     given either as one vector per fixed pose (cluster), or as a single
+     vector that is treated as one cluster. Clusters may also be given
+     as CompactPoses or as PermutedPoses views, e.g. scrambled data.
    Xinit,Yinit,Zinit: Initial guesses of X,Y,Z matrices.
  Outputs:
    X_cal,Y_cal,Z_cal: Calibrated X,Y,Z matrices
+   cost: optional, metric of the data at X_cal,Y_cal,Z_cal
+
+ The mean and covariance of every cluster are computed once before the
+ iterations, and each cluster contributes one MbMat_1 / MbMat_2 block.
+ Refinements of the same data from several initial guesses can share
+ them by passing an AxbyczProb3Stats instead of the data.
+ Each block is weighted by the number of samples in its cluster, so that
+ larger clusters count proportionally more in the least squares solution.
+
+ Every iteration solves the 18x18 normal equations M^T M xi = M^T b.
+ They are accumulated block by block instead of stacking the full
+ 21*(Ni+Nj) x 18 system M, so memory does not grow with the number of
+ clusters. For debugging, pass M_full and b_full to receive the stacked
+ (weighted) system of the last iteration.
+
+ AxbyczProb3Params selects the step strategy and holds the tolerances and
+ the iteration limit. Gauss-Newton takes the full step every iteration.
+ Levenberg-Marquardt and dogleg only accept a step that decreases the
+ metric of the data, and otherwise increase the damping or shrink the
+ trust region, which keeps poor initial guesses from oscillating.
+
+ The iterations stop when the step norm or the metric of the data drops
+ below tol. metric() is a pass over every raw sample, while the normal
+ equations come with the iteration anyway. With metric_every = k != 1
+ the convergence test uses the normal-equation residual ||M^T b|| per
+ sample instead, which vanishes at a least squares solution also for
+ noisy data, and damped steps are judged by the root mean square of b.
+ The metric is then checked on its own against tol every k iterations
+ (never for k = 0), and pass cost to receive it at the returned solution.
+
+ The refinement runs in the scalar type of Xinit, Yinit and Zinit. With
+ Matrix4f initial guesses the statistics, the normal equations and the
+ metric (on PoseArrayf copies of the data) are computed in float, while
+ the data itself may stay in double. M_full and b_full are double in
+ either case.
 
 Author: Sipu Ruan, ruansp@jhu.edu, November 2017 (MATLAB Version)
 
@@ -49,437 +87,581 @@ SE3Adinv computes the inverse of the adjoint representation of an element of SE(
 #define AXBYCZPROB3_H
 
 #include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <mutex>
 #include <Eigen/Dense>
-#include <unsupported/Eigen/MatrixFunctions>
 #include <vector>
 #include "metric.h"
+#include "poseArray.h"
+#include "so3Vec.h"
+#include "SE3.h"
+#include "se3ExpLog.h"
+#include "poseStats.h"
+#include "permutedPoses.h"
+
+// Rows 1-12: AXB = YCZ, rows 13-21: Sigma^1_B = R_Z^T Sigma^1_C R_Z
+template <typename Scalar>
+void MbMat_1(Eigen::Matrix<Scalar, 21, 18> &M,
+             Eigen::Matrix<Scalar, 21, 1> &b,
+             const Eigen::Matrix<Scalar, 4, 4> &A,
+             const Eigen::Matrix<Scalar, 4, 4> &X,
+             const Eigen::Matrix<Scalar, 4, 4> &B,
+             const Eigen::Matrix<Scalar, 4, 4> &Y,
+             const Eigen::Matrix<Scalar, 4, 4> &C,
+             const Eigen::Matrix<Scalar, 4, 4> &Z,
+             const Eigen::Matrix<Scalar, 6, 6> &SigB,
+             const Eigen::Matrix<Scalar, 6, 6> &SigC) {
+    typedef Eigen::Matrix<Scalar, 3, 1> Vector3;
+    typedef Eigen::Matrix<Scalar, 3, 3> Matrix3;
+    typedef Eigen::Matrix<Scalar, 4, 4> Matrix4;
+    typedef Eigen::Matrix<Scalar, 6, 6> Matrix6;
 
-void meanCov(const std::vector<Eigen::Matrix4d> &X,
-             int N,
-             std::vector<Eigen::MatrixXd> &Mean,
-             std::vector<Eigen::MatrixXd> &Cov) {
-
-    Mean.resize(N, Eigen::Matrix4d::Identity());
-    Cov.resize(N, Eigen::Matrix<double, 6, 6>::Zero());
-
-    // Initial approximation of Mean
-    Eigen::Matrix4d sum_se = Eigen::Matrix4d::Zero();
-    for (int i = 0; i < N; i++) {
-        sum_se += X[i].log();
-        Mean[i] = ((1.0 / N) * sum_se).exp();
-    }
-
-    // Iterative process to calculate the true Mean
-    Eigen::Matrix4d diff_se = Eigen::Matrix4d::Ones();
-    int max_num = 100;
-    double tol = 1e-5;
-    int count = 1;
-    while (diff_se.norm() >= tol && count <= max_num) {
-        diff_se = Eigen::Matrix4d::Zero();
-        for (int i = 0; i < N; i++) {
-            diff_se += (Mean[i].inverse() * X[i]).log();
-            Mean[i] *= ((1.0 / N)* diff_se).exp();
-        }
-        count++;
-    }
-
-    // Covariance
-    for (int i = 0; i < N; i++) {
-        diff_se = (Mean[i].inverse() * X[i]).log();
-        Eigen::VectorXd diff_vex(6);
-        diff_vex << Eigen::Map<Eigen::Vector3d>(diff_se.block<3,3>(0,0).data()), diff_se.block<3,1>(0,3);
-        Cov[i] += diff_vex * diff_vex.transpose();
-        Cov[i] /= N;
-    }
-}
-
-Eigen::Matrix3d skew(Eigen::Vector3d v) {
-    Eigen::Matrix3d M;
-
-    // Fill in the elements of the matrix according to the formula
-    M << 0, -v(2), v(1),
-            v(2), 0, -v(0),
-            -v(1), v(0), 0;
-
-    return M;
-}
-
-Eigen::Matrix4d SE3inv(const Eigen::Matrix4d& X) {
-    Eigen::Matrix4d invX;
-    invX << X.block<3,3>(0,0).transpose(), -X.block<3,3>(0,0).transpose() * X.block<3,1>(0,3),
-            0, 0, 0, 1;
-    return invX;
-}
-
-Eigen::Matrix<double, 6, 6> SE3Ad(const Eigen::Matrix4d& X) {
-    Eigen::Matrix3d R = X.block<3,3>(0,0);
-    Eigen::Vector3d t = X.block<3,1>(0,3);
-
-    Eigen::Matrix<double, 6, 6> A;
-    A << R, Eigen::Matrix3d::Zero(),
-            skew(t) * R, R;
-    return A;
-}
-
-Eigen::Matrix<double, 6, 6> SE3Adinv(const Eigen::Matrix4d& X) {
-    Eigen::Matrix3d R = X.block<3,3>(0,0);
-    Eigen::Vector3d t = X.block<3,1>(0,3);
-
-    Eigen::Matrix<double, 6, 6> A;
-    A << R.transpose(), Eigen::Matrix3d::Zero(),
-            -(skew(R.transpose() * t)) * R.transpose(), R.transpose();
-    return A;
-}
-
-void MbMat_1(Eigen::MatrixXd &M,
-             Eigen::MatrixXd &b,
-             const Eigen::MatrixXd &A,
-             const Eigen::MatrixXd &X,
-             const Eigen::MatrixXd &B,
-             const Eigen::MatrixXd &Y,
-             const Eigen::MatrixXd &C,
-             const Eigen::MatrixXd &Z,
-             const Eigen::MatrixXd &SigB,
-             const Eigen::MatrixXd &SigC) {
     // Construction M and b matrices
-    Eigen::Vector3d e1(1, 0, 0);
-    Eigen::Vector3d e2(0, 1, 0);
-    Eigen::Vector3d e3(0, 0, 1);
+    Vector3 e1(1, 0, 0);
+    Vector3 e2(0, 1, 0);
+    Vector3 e3(0, 0, 1);
+
+    Matrix3 RAX = A.template block<3,3>(0,0) * X.template block<3,3>(0,0);
+    Matrix3 RCZ = C.template block<3,3>(0,0) * Z.template block<3,3>(0,0);
+    Matrix3 RYCZ = Y.template block<3,3>(0,0) * RCZ;
 
     // AXB = YCZ
     // Rotation part
-    Eigen::Matrix3d M11 = -A.block<3,3>(0,0) * X.block<3,3>(0,0) * skew(B.block<3,3>(0,0)*e1);
-    Eigen::Matrix3d M13 = Y.block<3,3>(0,0) * skew(C.block<3,3>(0,0)*Z.block<3,3>(0,0)*e1);
-    Eigen::Matrix3d M15 = Y.block<3,3>(0,0) * C.block<3,3>(0,0) * Z.block<3,3>(0,0) * skew(e1);
+    Matrix3 M11 = -RAX * skew(B.template block<3,3>(0,0)*e1);
+    Matrix3 M13 = Y.template block<3,3>(0,0) * skew(RCZ*e1);
+    Matrix3 M15 = RYCZ * skew(e1);
 
-    Eigen::Matrix3d M21 = -A.block<3,3>(0,0) * X.block<3,3>(0,0) * skew(B.block<3,3>(0,0)*e2);
-    Eigen::Matrix3d M23 = Y.block<3,3>(0,0) * skew(C.block<3,3>(0,0)*Z.block<3,3>(0,0)*e2);
-    Eigen::Matrix3d M25 = Y.block<3,3>(0,0) * C.block<3,3>(0,0) * Z.block<3,3>(0,0) * skew(e2);
+    Matrix3 M21 = -RAX * skew(B.template block<3,3>(0,0)*e2);
+    Matrix3 M23 = Y.template block<3,3>(0,0) * skew(RCZ*e2);
+    Matrix3 M25 = RYCZ * skew(e2);
 
-    Eigen::Matrix3d M31 = -A.block<3,3>(0,0) * X.block<3,3>(0,0) * skew(B.block<3,3>(0,0)*e3);
-    Eigen::Matrix3d M33 = Y.block<3,3>(0,0) * skew(C.block<3,3>(0,0)*Z.block<3,3>(0,0)*e3);
-    Eigen::Matrix3d M35 = Y.block<3,3>(0,0) * C.block<3,3>(0,0) * Z.block<3,3>(0,0) * skew(e3);
+    Matrix3 M31 = -RAX * skew(B.template block<3,3>(0,0)*e3);
+    Matrix3 M33 = Y.template block<3,3>(0,0) * skew(RCZ*e3);
+    Matrix3 M35 = RYCZ * skew(e3);
 
     // Translation part
-    Eigen::Matrix3d M41 = -A.block<3,3>(0,0) * X.block<3,3>(0,0) * skew(B.block<3,1>(0,3));
-    Eigen::Matrix3d M42 = A.block<3,3>(0,0) * X.block<3,3>(0,0);
-    Eigen::Matrix3d M43 = Y.block<3, 3>(0, 0) * skew(C.block<3, 3>(0, 0) * Z.block<3,1>(0,3) + C.block<3,1>(0,3));
-    Eigen::Matrix3d M44 = -Y.block<3,3>(0,0);
-    Eigen::Matrix3d M46 = -Y.block<3,3>(0,0) * C.block<3,3>(0,0) * Z.block<3,3>(0,0);
-
-    M.resize(12, 18);
-    M << M11, Eigen::Matrix3d::Zero(3, 3), M13, Eigen::Matrix3d::Zero(3, 3), M15, Eigen::Matrix3d::Zero(3, 3),
-            M21, Eigen::Matrix3d::Zero(3, 3), M23, Eigen::Matrix3d::Zero(3, 3), M25, Eigen::Matrix3d::Zero(3, 3),
-            M31, Eigen::Matrix3d::Zero(3,3) , M33, Eigen::Matrix3d::Zero(3,3) , M35, Eigen::Matrix3d::Zero (3,3),
-            M41, M42,                          M43, M44,                        Eigen::Matrix3d::Zero (3,3), M46;
+    Matrix3 M41 = -RAX * skew(B.template block<3,1>(0,3));
+    Matrix3 M42 = RAX;
+    Matrix3 M43 = Y.template block<3, 3>(0, 0) * skew(C.template block<3, 3>(0, 0) * Z.template block<3,1>(0,3) + C.template block<3,1>(0,3));
+    Matrix3 M44 = -Y.template block<3,3>(0,0);
+    Matrix3 M46 = -RYCZ;
+
+    // SigBi = Ad^{-1}(Z) * SigCi * Ad^{-T}(Z), rotational block
+    Matrix3 M55 = -skew(SigB.template block<3,1>(0,0)) + SigB.template block<3,3>(0,0) * skew(e1);
+    Matrix3 M65 = -skew(SigB.template block<3,1>(0,1)) + SigB.template block<3,3>(0,0) * skew(e2);
+    Matrix3 M75 = -skew(SigB.template block<3,1>(0,2)) + SigB.template block<3,3>(0,0) * skew(e3);
+
+    Matrix3 Zero3 = Matrix3::Zero();
+
+    M << M11, Zero3, M13, Zero3, M15, Zero3,
+         M21, Zero3, M23, Zero3, M25, Zero3,
+         M31, Zero3, M33, Zero3, M35, Zero3,
+         M41, M42,   M43, M44,   Zero3, M46,
+         Zero3, Zero3, Zero3, Zero3, M55, Zero3,
+         Zero3, Zero3, Zero3, Zero3, M65, Zero3,
+         Zero3, Zero3, Zero3, Zero3, M75, Zero3;
 
     // RHS
-    Eigen::MatrixXd RHS = -A * X * B + Y * C * Z;
-
-    b.resize(12, 1);
-    b << RHS.block<3, 1>(0, 0), RHS.block<3, 1>(0, 1), RHS.block<3, 1>(0, 2), RHS.block<3, 1>(0, 3);
-
-    // SigBi = Ad^{-1}(Z) * SigCi * Ad^{-T}(Z)
-    // First block
-    Eigen::Matrix3d M55 = -skew(SigB.block<3,1>(0,0)) + SigB.block<3,3>(0,0) * skew(e1);
-    Eigen::Matrix3d M56 = Eigen::Matrix3d::Zero();
-    Eigen::Matrix3d M65 = -skew(SigB.block<3,1>(0,1)) + SigB.block<3,3>(0,0) * skew(e2);
-    Eigen::Matrix3d M66 = Eigen::Matrix3d::Zero();
-    Eigen::Matrix3d M75 = -skew(SigB.block<3,1>(0,2)) + SigB.block<3,3>(0,0) * skew(e3);
-    Eigen::Matrix3d M76 = Eigen::Matrix3d::Zero();
-
-    // Second block
-    Eigen::Matrix3d M85 = -skew(SigB.block<3,1>(0,3)) + SigB.block<3,3>(0,3) * skew(e1);
-    Eigen::Matrix3d M86 = SigB.block<3,3>(0,0) * skew(e1);
-    Eigen::Matrix3d M95 = -skew(SigB.block<3,1>(0,4)) + SigB.block<3,3>(0,3) * skew(e2);
-    Eigen::Matrix3d M96 = SigB.block<3,3>(0,0) * skew(e2);
-    Eigen::Matrix3d M105 = -skew(SigB.block<3,1>(0,5)) + SigB.block<3,3>(0,3) * skew(e3);
-    Eigen::Matrix3d M106 = SigB.block<3,3>(0,0) * skew(e3);
-
-    // Third block
-    Eigen::Matrix3d M115 = -skew(SigB.block<3,1>(3,0)) + SigB.block<3,3>(3,0) * skew(e1);
-    Eigen::Matrix3d M116 = -skew(SigB.block<3,1>(0,0));
-    Eigen::Matrix3d M125 = -skew(SigB.block<3,1>(3,1)) + SigB.block<3,3>(3,0) * skew(e2);
-    Eigen::Matrix3d M126 = -skew(SigB.block<3,1>(0,1));
-    Eigen::Matrix3d M135 = -skew(SigB.block<3,1>(3,2)) + SigB.block<3,3>(3,0) * skew(e3);
-    Eigen::Matrix3d M136 = -skew(SigB.block<3,1>(0,2));
-
-    // Fourth block
-    Eigen::Matrix3d M145 = -skew(SigB.block<3,1>(3,3)) + SigB.block<3,3>(3,3) * skew(e1);
-    Eigen::Matrix3d M146 = -skew(SigB.block<3,1>(0,3)) + SigB.block<3,3>(3,0) * skew(e1);
-    Eigen::Matrix3d M155 = -skew(SigB.block<3,1>(3,4)) + SigB.block<3,3>(3,3) * skew(e2);
-    Eigen::Matrix3d M156 = -skew(SigB.block<3,1>(0,4)) + SigB.block<3,3>(3,0) * skew(e2);
-    Eigen::Matrix3d M165 = -skew(SigB.block<3,1>(3,5)) + SigB.block<3,3>(3,3) * skew(e3);
-    Eigen::Matrix3d M166 = -skew(SigB.block<3,1>(0,5)) + SigB.block<3,3>(3,0) * skew(e3);
-
-    M.conservativeResize(M.rows() + 36, M.cols() + 9);
-    M.bottomRightCorner(36, 9) << Eigen::Matrix3d::Zero(),  M55,  M56,
-                                                Eigen::Matrix3d::Zero(),  M65,  M66,
-                                                Eigen::Matrix3d::Zero(),  M75,  M76,
-                                                Eigen::Matrix3d::Zero(),  M85,  M86,
-                                                Eigen::Matrix3d::Zero(),  M95,  M96,
-                                                Eigen::Matrix3d::Zero(), M105, M106,
-                                                Eigen::Matrix3d::Zero(), M115, M116,
-                                                Eigen::Matrix3d::Zero(), M125, M126,
-                                                Eigen::Matrix3d::Zero(), M135, M136,
-                                                Eigen::Matrix3d::Zero(), M145, M146,
-                                                Eigen::Matrix3d::Zero(), M155, M156,
-                                                Eigen::Matrix3d::Zero(), M165 ,M166;
-
-    Eigen::MatrixXd RHS2 = SE3Adinv(Z) * SigC * SE3Adinv(Z).transpose() - SigB;
-    RHS2.resize(3, 12);
-
-    b.resize(b.rows() + RHS2.size(), 1);
-    b.bottomRows(RHS2.size()) = Eigen::Map<Eigen::VectorXd>(RHS2.data(), RHS2.size());
+    Matrix4 RHS = -A * X * B + Y * C * Z;
+    Matrix6 AdZinv = SE3Adinv(Z);
+    Matrix6 RHS2 = AdZinv * SigC * AdZinv.transpose() - SigB;
+
+    b << RHS.template block<3, 1>(0, 0), RHS.template block<3, 1>(0, 1), RHS.template block<3, 1>(0, 2), RHS.template block<3, 1>(0, 3),
+         RHS2.template block<3, 1>(0, 0), RHS2.template block<3, 1>(0, 1), RHS2.template block<3, 1>(0, 2);
 }
 
-void MbMat_2(Eigen::MatrixXd &M,
-             Eigen::MatrixXd &b,
-             const Eigen::MatrixXd &C,
-             const Eigen::MatrixXd &Z,
-             const Eigen::MatrixXd &Binv,
-             const Eigen::MatrixXd &Yinv,
-             const Eigen::MatrixXd &A,
-             const Eigen::MatrixXd &X,
-             const Eigen::MatrixXd &SigB,
-             const Eigen::MatrixXd &SigA,
-             const Eigen::MatrixXd &B){
+// Rows 1-12: CZB^{-1} = Y^{-1}AX, rows 13-21: Sigma^1_{B^{-1}} = R_X^T Sigma^1_A R_X
+template <typename Scalar>
+void MbMat_2(Eigen::Matrix<Scalar, 21, 18> &M,
+             Eigen::Matrix<Scalar, 21, 1> &b,
+             const Eigen::Matrix<Scalar, 4, 4> &C,
+             const Eigen::Matrix<Scalar, 4, 4> &Z,
+             const Eigen::Matrix<Scalar, 4, 4> &Binv,
+             const Eigen::Matrix<Scalar, 4, 4> &Yinv,
+             const Eigen::Matrix<Scalar, 4, 4> &A,
+             const Eigen::Matrix<Scalar, 4, 4> &X,
+             const Eigen::Matrix<Scalar, 6, 6> &SigB,
+             const Eigen::Matrix<Scalar, 6, 6> &SigA,
+             const Eigen::Matrix<Scalar, 4, 4> &B){
+    typedef Eigen::Matrix<Scalar, 3, 1> Vector3;
+    typedef Eigen::Matrix<Scalar, 3, 3> Matrix3;
+    typedef Eigen::Matrix<Scalar, 4, 4> Matrix4;
+    typedef Eigen::Matrix<Scalar, 6, 6> Matrix6;
+
     // Construction M and b matrices
-    Eigen::Vector3d e1(1,0,0), e2(0,1,0), e3(0,0,1);
-    Eigen::Matrix3d Binv3 = B.topLeftCorner<3,3>().inverse();
-    Eigen::MatrixXd SigBinv = SE3Ad(B) * SigB * SE3Ad(B).transpose();
+    Vector3 e1(1,0,0), e2(0,1,0), e3(0,0,1);
+    Matrix3 Binv3 = B.template topLeftCorner<3,3>().transpose();
+    Matrix6 AdB = SE3Ad(B);
+    Matrix6 SigBinv = AdB * SigB * AdB.transpose();
+
+    Matrix3 RYAX = Yinv.template topLeftCorner<3,3>() * A.template topLeftCorner<3,3>() * X.template topLeftCorner<3,3>();
+    Matrix3 RCZ = C.template topLeftCorner<3,3>() * Z.template topLeftCorner<3,3>();
 
     // CZB^{-1} = Y^{-1}AX
     // Rotation part
-    Eigen::Matrix3d M11 = Yinv.topLeftCorner<3,3>() * A.topLeftCorner<3,3>() * X.topLeftCorner<3,3>() * skew(e1);
-    Eigen::Matrix3d M13 = -skew(Yinv.topLeftCorner<3,3>() * A.topLeftCorner<3,3>() * X.topLeftCorner<3,3>() * e1);
-    Eigen::Matrix3d M15 = -C.topLeftCorner<3,3>() * Z.topLeftCorner<3,3>() * skew(Binv3*e1);
+    Matrix3 M11 = RYAX * skew(e1);
+    Matrix3 M13 = -skew(RYAX * e1);
+    Matrix3 M15 = -RCZ * skew(Binv3*e1);
 
-    Eigen::Matrix3d M21 = Yinv.topLeftCorner<3,3>() * A.topLeftCorner<3,3>() * X.topLeftCorner<3,3>() * skew(e2);
-    Eigen::Matrix3d M23 = -skew(Yinv.topLeftCorner<3,3>() * A.topLeftCorner<3,3>() * X.topLeftCorner<3,3>() * e2);
-    Eigen::Matrix3d M25 = -C.topLeftCorner<3,3>() * Z.topLeftCorner<3,3>() * skew(Binv3*e2);
+    Matrix3 M21 = RYAX * skew(e2);
+    Matrix3 M23 = -skew(RYAX * e2);
+    Matrix3 M25 = -RCZ * skew(Binv3*e2);
 
-    Eigen::Matrix3d M31 = Yinv.topLeftCorner<3,3>() * A.topLeftCorner<3,3>() * X.topLeftCorner<3,3>() * skew(e3);
-    Eigen::Matrix3d M33 = -skew(Yinv.topLeftCorner<3,3>() * A.topLeftCorner<3,3>() * X.topLeftCorner<3,3>() * e3);
-    Eigen::Matrix3d M35 = -C.topLeftCorner<3,3>() * Z.topLeftCorner<3,3>() * skew(Binv3*e3);
+    Matrix3 M31 = RYAX * skew(e3);
+    Matrix3 M33 = -skew(RYAX * e3);
+    Matrix3 M35 = -RCZ * skew(Binv3*e3);
 
     // Translation Part
-    Eigen::Matrix3d M42 = -Yinv.block<3,3>(0,0) * A.block<3,3>(0,0) * X.block<3,3>(0,0);
-    Eigen::Matrix3d M43 = -skew(Yinv.block<3,3>(0,0) * A.block<3,3>(0,0) * X.block<3,1>(0,3) + Yinv.block<3,3>(0,0) * A.block<3,1>(0,3) + Yinv.block<3,1>(0,3));
-    Eigen::Matrix3d M44 = Eigen::Matrix3d::Identity();
-    Eigen::Matrix3d M45 = -C.block<3,3>(0,0) * Z.block<3,3>(0,0) * skew(Binv.block<3,1>(0,3));
-    Eigen::Matrix3d M46 = C.block<3,3>(0,0) * Z.block<3,3>(0,0);
-
-    M.resize(12, 18);
-    M << M11, Eigen::Matrix3d::Zero(), M13, Eigen::Matrix3d::Zero(), M15, Eigen::Matrix3d::Zero(),
-            M21, Eigen::Matrix3d::Zero(), M23, Eigen::Matrix3d::Zero(), M25, Eigen::Matrix3d::Zero(),
-            M31, Eigen::Matrix3d::Zero(), M33, Eigen::Matrix3d::Zero(), M35, Eigen::Matrix3d::Zero(),
-            Eigen::Matrix3d::Zero(), M42, M43, M44, M45, M46;
+    Matrix3 M42 = -RYAX;
+    Matrix3 M43 = -skew(Yinv.template block<3,3>(0,0) * A.template block<3,3>(0,0) * X.template block<3,1>(0,3) + Yinv.template block<3,3>(0,0) * A.template block<3,1>(0,3) + Yinv.template block<3,1>(0,3));
+    Matrix3 M44 = Matrix3::Identity();
+    Matrix3 M45 = -RCZ * skew(Binv.template block<3,1>(0,3));
+    Matrix3 M46 = RCZ;
+
+    // SigBi^{-1} = Ad^{-1}(X) * SigAi * Ad^{-T}(X), rotational block
+    Matrix3 M51 = -skew(SigBinv.template block<3,1>(0,0)) + SigBinv.template block<3,3>(0,0) * skew(e1);
+    Matrix3 M61 = -skew(SigBinv.template block<3,1>(0,1)) + SigBinv.template block<3,3>(0,0) * skew(e2);
+    Matrix3 M71 = -skew(SigBinv.template block<3,1>(0,2)) + SigBinv.template block<3,3>(0,0) * skew(e3);
+
+    Matrix3 Zero3 = Matrix3::Zero();
+
+    M << M11,   Zero3, M13, Zero3, M15, Zero3,
+         M21,   Zero3, M23, Zero3, M25, Zero3,
+         M31,   Zero3, M33, Zero3, M35, Zero3,
+         Zero3, M42,   M43, M44,   M45, M46,
+         M51,   Zero3, Zero3, Zero3, Zero3, Zero3,
+         M61,   Zero3, Zero3, Zero3, Zero3, Zero3,
+         M71,   Zero3, Zero3, Zero3, Zero3, Zero3;
 
     // RHS
-    Eigen::MatrixXd RHS = - C * Z * Binv + Yinv * A * X;
-
-    b.resize(12, 1);
-    b << RHS.block<3, 1>(0, 0), RHS.block<3, 1>(0, 1),
-            RHS.block<3, 1>(0, 2), RHS.block<3, 1>(0, 3);
-
-    // SigBi^{-1} = Ad^{-1}(X) * SigAi * Ad^{-T}(X)
-    // First block
-    Eigen::Matrix3d M51 = -skew(SigBinv.block<3,1>(0,0)) + SigBinv.block<3,3>(0,0) * skew(e1);
-    Eigen::Matrix3d M52 = Eigen::Matrix3d::Zero();
-    Eigen::Matrix3d M61 = -skew(SigBinv.block<3,1>(0,1)) + SigBinv.block<3,3>(0,0) * skew(e2);
-    Eigen::Matrix3d M62 = Eigen::Matrix3d::Zero();
-    Eigen::Matrix3d M71 = -skew(SigBinv.block<3,1>(0,2)) + SigBinv.block<3,3>(0,0) * skew(e3);
-    Eigen::Matrix3d M72 = Eigen::Matrix3d::Zero();
-
-    // Second block
-    Eigen::Matrix3d M81 = -skew(SigBinv.block<3,1>(0,3)) + SigBinv.block<3,3>(0,3) * skew(e1);
-    Eigen::Matrix3d M82 = SigBinv.block<3,3>(0,0) * skew(e1);
-    Eigen::Matrix3d M91 = -skew(SigBinv.block<3,1>(0,4)) + SigBinv.block<3,3>(0,3) * skew(e2);
-    Eigen::Matrix3d M92 = SigBinv.block<3,3>(0,0) * skew(e2);
-    Eigen::Matrix3d M101 = -skew(SigBinv.block<3,1>(0,5)) + SigBinv.block<3,3>(0,3) * skew(e3);
-    Eigen::Matrix3d M102 = SigBinv.block<3,3>(0,0) * skew(e3);
-
-    // Third block
-    Eigen::Matrix3d M111 = -skew(SigBinv.block<3,1>(3,0)) + SigBinv.block<3,3>(3,0) * skew(e1);
-    Eigen::Matrix3d M112 = -skew(SigBinv.block<3,1>(0,0));
-    Eigen::Matrix3d M121 = -skew(SigBinv.block<3,1>(3,1)) + SigBinv.block<3,3>(3,0) * skew(e2);
-    Eigen::Matrix3d M122 = -skew(SigBinv.block<3,1>(0,1));
-    Eigen::Matrix3d M131 = -skew(SigBinv.block<3,1>(3,2)) + SigBinv.block<3,3>(3,0) * skew(e3);
-    Eigen::Matrix3d M132 = -skew(SigBinv.block<3,1>(0,2));
-
-    // Fourth block
-    Eigen::Matrix3d M141 = -skew(SigBinv.block<3,1>(3,3)) + SigBinv.block<3,3>(3,3) * skew(e1);
-    Eigen::Matrix3d M142 = -skew(SigBinv.block<3,1>(0,3)) + SigBinv.block<3,3>(3,0) * skew(e1);
-    Eigen::Matrix3d M151 = -skew(SigBinv.block<3,1>(3,4)) + SigBinv.block<3,3>(3,3) * skew(e2);
-    Eigen::Matrix3d M152 = -skew(SigBinv.block<3,1>(0,4)) + SigBinv.block<3,3>(3,0) * skew(e2);
-    Eigen::Matrix3d M161 = -skew(SigBinv.block<3,1>(3,5)) + SigBinv.block<3,3>(3,3) * skew(e3);
-    Eigen::Matrix3d M162 = -skew(SigBinv.block<3,1>(0,5)) + SigBinv.block<3,3>(3,0) * skew(e3);
-
-    M.conservativeResize(M.rows() + 36, M.cols() + 9);
-    M.bottomRightCorner(36, 9) << Eigen::Matrix3d::Zero(),  M51,  M52,
-                                                Eigen::Matrix3d::Zero(),  M61,  M62,
-                                                Eigen::Matrix3d::Zero(),  M71,  M72,
-                                                Eigen::Matrix3d::Zero(),  M81,  M82,
-                                                Eigen::Matrix3d::Zero(),  M91,  M92,
-                                                Eigen::Matrix3d::Zero(), M101, M102,
-                                                Eigen::Matrix3d::Zero(), M111, M112,
-                                                Eigen::Matrix3d::Zero(), M121, M122,
-                                                Eigen::Matrix3d::Zero(), M131, M132,
-                                                Eigen::Matrix3d::Zero(), M141, M142,
-                                                Eigen::Matrix3d::Zero(), M151, M152,
-                                                Eigen::Matrix3d::Zero(), M161 ,M162;
-
-    Eigen::MatrixXd RHS2 = SE3Adinv(X) * SigA * SE3Adinv(X).transpose() - SigBinv;
-    RHS2.resize(3, 12);
-
-    b.resize(b.rows() + RHS2.size(), 1);
-    b.bottomRows(RHS2.size()) = Eigen::Map<Eigen::VectorXd>(RHS2.data(), RHS2.size());
+    Matrix4 RHS = - C * Z * Binv + Yinv * A * X;
+    Matrix6 AdXinv = SE3Adinv(X);
+    Matrix6 RHS2 = AdXinv * SigA * AdXinv.transpose() - SigBinv;
+
+    b << RHS.template block<3, 1>(0, 0), RHS.template block<3, 1>(0, 1), RHS.template block<3, 1>(0, 2), RHS.template block<3, 1>(0, 3),
+         RHS2.template block<3, 1>(0, 0), RHS2.template block<3, 1>(0, 1), RHS2.template block<3, 1>(0, 2);
 }
 
-void axbyczProb3(const std::vector<Eigen::Matrix4d> &A1,
-                 const std::vector<Eigen::Matrix4d> &B1,
-                 const std::vector<Eigen::Matrix4d> &C1,
-                 const std::vector<Eigen::Matrix4d> &A2,
-                 const std::vector<Eigen::Matrix4d> &B2,
-                 const std::vector<Eigen::Matrix4d> &C2,
-                 const Eigen::Matrix4d &Xinit,
-                 const Eigen::Matrix4d &Yinit,
-                 const Eigen::Matrix4d &Zinit,
-                 Eigen::Matrix4d &X_cal,
-                 Eigen::Matrix4d &Y_cal,
-                 Eigen::Matrix4d &Z_cal,
-                 int& num) {
-    // Initiation
-    int Ni = A1.size();
-    int Nj = C2.size();
-    X_cal = Xinit;
-    Y_cal = Yinit;
-    Z_cal = Zinit;
-    Eigen::Matrix4d Xupdate = Xinit;
-    Eigen::Matrix4d Yupdate = Yinit;
-    Eigen::Matrix4d Zupdate = Zinit;
-    Eigen::VectorXd xi = Eigen::VectorXd::Ones(18);
-
-    int max_num = 2;
-    double tol = 1e-5;
-
-    // Calculate mean and covariance of varying data
-    std::vector<Eigen::MatrixXd> A1_m, B1_m, C1_m, SigA1, SigB1, SigC1;
-    meanCov(A1, Ni, A1_m, SigA1);
-    meanCov(B1, Ni, B1_m, SigB1);   
-    meanCov(C1, Ni, C1_m, SigC1);
-
-    // invert B2
-    std::vector<Eigen::Matrix4d> B2inv(B2.size());
-    for (int i = 0; i < B2.size(); ++i) {
-        B2inv[i] = B2[i].inverse();
+// Settings of the iterative refinement
+struct AxbyczProb3Params {
+    enum Method {
+        GaussNewton,        // undamped steps, as in the MATLAB version
+        LevenbergMarquardt, // adaptive damping lambda * diag(M^T M)
+        Dogleg              // trust region of radius radius
+    };
+
+    Method method = GaussNewton;
+    int max_num = 500;          // maximum number of iterations
+    double tol = 1e-5;          // tolerance on the step norm, the metric and the residual
+    int max_trials = 10;        // rejected steps tried per iteration (LM, dogleg)
+    double lambda_init = 1e-3;  // initial LM damping
+    double lambda_up = 10.0;    // damping factor after a rejected step
+    double lambda_down = 0.1;   // damping factor after an accepted step
+    double radius_init = 1.0;   // initial dogleg trust region radius
+    int metric_every = 1;       // evaluate metric() every k iterations, 0: never
+
+    // Called after every iteration with the iteration count and the current
+    // cost (the metric for metric_every = 1, the root mean square of b
+    // otherwise). Returning false stops the refinement early.
+    std::function<bool(int, double)> keep_going;
+};
+
+// Dogleg step for the normal equations MtM * xi = Mtb within radius
+template <typename Scalar>
+Eigen::Matrix<Scalar, 18, 1> doglegStep(const Eigen::Matrix<Scalar, 18, 18> &MtM,
+                                        const Eigen::Matrix<Scalar, 18, 1> &Mtb,
+                                        Scalar radius) {
+    Eigen::Matrix<Scalar, 18, 1> gn = MtM.ldlt().solve(Mtb);
+    if (gn.norm() <= radius) {
+        return gn;
     }
 
-    std::vector<Eigen::MatrixXd> A2_m, B2_m, B2inv_m, C2_m, SigA2, SigB2, SigB2inv, SigC2;
-    meanCov(A2, Nj, A2_m, SigA2);
-    meanCov(B2, Nj, B2_m, SigB2);
-    meanCov(B2inv, Nj, B2inv_m, SigB2inv);
-    meanCov(C2, Nj, C2_m, SigC2);
+    // Steepest descent step to the minimum along Mtb (Cauchy point)
+    Scalar gMg = Mtb.dot(MtM * Mtb);
+    if (gMg <= 0) {
+        return radius / Mtb.norm() * Mtb;
+    }
+    Eigen::Matrix<Scalar, 18, 1> sd = Mtb.squaredNorm() / gMg * Mtb;
+    if (sd.norm() >= radius) {
+        return radius / sd.norm() * sd;
+    }
 
-    // Calculate M and b matrices when fixing A and C separately
-    double diff = metric(A1,B1,C1,Xupdate,Yupdate,Zupdate) +
-                  metric(A2,B2,C2,Xupdate,Yupdate,Zupdate);
-    diff = 1;
+    // Walk from the Cauchy point towards gn until the boundary
+    Eigen::Matrix<Scalar, 18, 1> d = gn - sd;
+    Scalar dd = d.squaredNorm();
+    Scalar sdd = sd.dot(d);
+    Scalar beta = (-sdd + std::sqrt(sdd * sdd + dd * (radius * radius - sd.squaredNorm()))) / dd;
+    return sd + beta * d;
+}
 
-    std::vector<Eigen::MatrixXd> MM(Ni+Nj);
-    std::vector<Eigen::MatrixXd> bb(Ni+Nj);
-    while (xi.norm() >= tol && diff >= tol && num <= max_num) {
-        for (int i = 0; i < Ni; i++) {
-            MbMat_1(MM[i], bb[i], A1_m[i], Xupdate,
-                    B1_m[i], Yupdate, C1_m[i], Zupdate,
-                    SigB1[i], SigC1[i]);
-        }
+// Mean of the metric over all samples of all clusters, each cluster given
+// as a vector of Matrix4d or as a PoseArray
+template <typename Sequence, typename Scalar>
+Scalar axbyczProb3Cost(const std::vector<Sequence> &A1,
+                       const std::vector<Sequence> &B1,
+                       const std::vector<Sequence> &C1,
+                       const std::vector<Sequence> &A2,
+                       const std::vector<Sequence> &B2,
+                       const std::vector<Sequence> &C2,
+                       const Eigen::Matrix<Scalar, 4, 4> &X,
+                       const Eigen::Matrix<Scalar, 4, 4> &Y,
+                       const Eigen::Matrix<Scalar, 4, 4> &Z) {
+    Scalar diff1 = 0, diff2 = 0;
+    int N1 = 0, N2 = 0;
+    for (size_t i = 0; i < A1.size(); ++i) {
+        diff1 += A1[i].size() * metric(A1[i], B1[i], C1[i], X, Y, Z);
+        N1 += A1[i].size();
+    }
+    for (size_t j = 0; j < C2.size(); ++j) {
+        diff2 += C2[j].size() * metric(A2[j], B2[j], C2[j], X, Y, Z);
+        N2 += C2[j].size();
+    }
+    return diff1 / N1 + diff2 / N2;
+}
 
-        for (int j = 0; j < Nj; j++) {
-            MbMat_2(MM[j + Ni], bb[j + Ni],
-                    C2_m[j], Zupdate, B2inv_m[j],
-                    SE3inv(Yupdate), A2_m[j], Xupdate,
-                    SigB2[j], SigA2[j], B2_m[j]);
+// Mean, covariance and weight of every cluster of the data, computed once
+// and shared by all refinements of the same data, e.g. the starts of
+// axbyczMultiStart. The PoseArray copies for the metric are made on the
+// first call of cost(), also when the refinements run concurrently, and
+// the inverse statistics are computed up front, so that concurrent
+// refinements only read the stats. The data must outlive the statistics.
+template <typename Scalar>
+class AxbyczProb3Stats {
+public:
+    typedef Eigen::Matrix<Scalar, 4, 4> Matrix4;
+
+    template <typename Sequence>
+    AxbyczProb3Stats(const std::vector<Sequence> &A1,
+                     const std::vector<Sequence> &B1,
+                     const std::vector<Sequence> &C1,
+                     const std::vector<Sequence> &A2,
+                     const std::vector<Sequence> &B2,
+                     const std::vector<Sequence> &C2)
+        : N1(0), N2(0) {
+        for (size_t i = 0; i < A1.size(); ++i) {
+            A1_.emplace_back(A1[i]);
+            B1_.emplace_back(B1[i]);
+            C1_.emplace_back(C1[i]);
+            w1.push_back(A1[i].size());
+            N1 += A1[i].size();
         }
-
-        Eigen::MatrixXd M;
-        Eigen::MatrixXd b;
-        Eigen::MatrixXd M1;
-        Eigen::MatrixXd M2;
-        Eigen::MatrixXd M3;
-        Eigen::MatrixXd M4;
-
-        for (int k = 0; k < Ni + Nj; k++) {
-            M.conservativeResize(M.rows() + MM[k].rows(), MM[k].cols());
-            M.bottomRows(MM[k].rows()) = MM[k];
-            b.conservativeResize(b.rows() + bb[k].rows(), b.cols() + bb[k].cols());
-            b.bottomRightCorner(bb[k].rows(), bb[k].cols()) = bb[k];
+        for (size_t j = 0; j < C2.size(); ++j) {
+            A2_.emplace_back(A2[j]);
+            B2_.emplace_back(B2[j]);
+            C2_.emplace_back(C2[j]);
+            w2.push_back(C2[j].size());
+            N2 += C2[j].size();
+            // PoseStatsT caches the inverse on first use without a lock,
+            // so compute it here before the refinements share the stats
+            B2_.back().meanInv();
         }
 
-        for (int k = 0; k < Ni; k++) {
-            M1.conservativeResize(M1.rows() + MM[k].block(0, 0, 12, MM[k].cols()).rows(), MM[k].cols());
-            M1.bottomRows(MM[k].block(0, 0, 12, MM[k].cols()).rows()) = MM[k].block(0, 0, 12, MM[k].cols());
-            M2.conservativeResize(M2.rows() + MM[k].block(12, 0, 9, MM[k].cols()).rows(), MM[k].cols());
-            M2.bottomRows(MM[k].block(12, 0, 9, MM[k].cols()).rows()) = MM[k].block(12, 0, 9, MM[k].cols());
-        }
+        make_poses_ = [this, &A1, &B1, &C1, &A2, &B2, &C2]() {
+            for (size_t i = 0; i < A1.size(); ++i) {
+                poseA1_.emplace_back(A1[i]);
+                poseB1_.emplace_back(B1[i]);
+                poseC1_.emplace_back(C1[i]);
+            }
+            for (size_t j = 0; j < C2.size(); ++j) {
+                poseA2_.emplace_back(A2[j]);
+                poseB2_.emplace_back(B2[j]);
+                poseC2_.emplace_back(C2[j]);
+            }
+        };
+    }
 
-        for (int k = Ni; k < Ni + Nj; k++) {
-            M3.conservativeResize(M3.rows() + MM[k].block(0, 0, 12, MM[k].cols()).rows(), MM[k].cols());
-            M3.bottomRows(MM[k].block(0, 0, 12, MM[k].cols()).rows()) = MM[k].block(0, 0, 12, MM[k].cols());
-            M4.conservativeResize(M4.rows() + MM[k].block(12, 0, 9, MM[k].cols()).rows(), MM[k].cols());
-            M4.bottomRows(MM[k].block(12, 0, 9, MM[k].cols()).rows()) = MM[k].block(12, 0, 9, MM[k].cols());
-        }
+    const PoseStatsT<Scalar> &A1(int i) const { return A1_[i]; }
+    const PoseStatsT<Scalar> &B1(int i) const { return B1_[i]; }
+    const PoseStatsT<Scalar> &C1(int i) const { return C1_[i]; }
+    const PoseStatsT<Scalar> &A2(int j) const { return A2_[j]; }
+    const PoseStatsT<Scalar> &B2(int j) const { return B2_[j]; }
+    const PoseStatsT<Scalar> &C2(int j) const { return C2_[j]; }
+
+    // Mean of the metric over all samples, see axbyczProb3Cost
+    Scalar cost(const Matrix4 &X, const Matrix4 &Y, const Matrix4 &Z) const {
+        std::call_once(poses_made_, make_poses_);
+        return axbyczProb3Cost(poseA1_, poseB1_, poseC1_, poseA2_, poseB2_, poseC2_, X, Y, Z);
+    }
 
-        // Inversion to get xi_X, xi_Y, xi_Z
-        Eigen::MatrixXd xi_new = (M.transpose() * M).ldlt().solve(M.transpose() * b);
+    std::vector<Scalar> w1, w2;  // samples per cluster
+    int N1, N2;                  // samples in all fixed-A / fixed-C clusters
+
+private:
+    std::vector<PoseStatsT<Scalar>> A1_, B1_, C1_, A2_, B2_, C2_;
+    std::function<void()> make_poses_;
+    mutable std::once_flag poses_made_;
+    mutable std::vector<PoseArrayT<Scalar>> poseA1_, poseB1_, poseC1_, poseA2_, poseB2_, poseC2_;
+};
+
+template <typename Scalar>
+void axbyczProb3(const AxbyczProb3Stats<Scalar> &stats,
+                 const Eigen::Matrix<Scalar, 4, 4> &Xinit,
+                 const Eigen::Matrix<Scalar, 4, 4> &Yinit,
+                 const Eigen::Matrix<Scalar, 4, 4> &Zinit,
+                 Eigen::Matrix<Scalar, 4, 4> &X_cal,
+                 Eigen::Matrix<Scalar, 4, 4> &Y_cal,
+                 Eigen::Matrix<Scalar, 4, 4> &Z_cal,
+                 int& num,
+                 const AxbyczProb3Params &params = AxbyczProb3Params(),
+                 Eigen::MatrixXd *M_full = nullptr,
+                 Eigen::MatrixXd *b_full = nullptr,
+                 Scalar *cost = nullptr) {
+    typedef Eigen::Matrix<Scalar, 4, 4> Matrix4;
 
-        double diff1 = 0;
-        double diff2 = 0;
+    // Initiation
+    int Ni = stats.w1.size();
+    int Nj = stats.w2.size();
+    const std::vector<Scalar> &w1 = stats.w1;
+    const std::vector<Scalar> &w2 = stats.w2;
+    int N1 = stats.N1;
+    int N2 = stats.N2;
+    X_cal = Xinit;
+    Y_cal = Yinit;
+    Z_cal = Zinit;
+    Matrix4 Xupdate = Xinit;
+    Matrix4 Yupdate = Yinit;
+    Matrix4 Zupdate = Zinit;
+    Eigen::Matrix<Scalar, 18, 1> xi = Eigen::Matrix<Scalar, 18, 1>::Ones();
+
+    auto error = [&](const Matrix4& X, const Matrix4& Y, const Matrix4& Z) {
+        return stats.cost(X, Y, Z);
+    };
+
+    // Accumulate the normal equations of all blocks at (X, Y, Z). Returns
+    // the root mean square of the weighted residual b.
+    Eigen::Matrix<Scalar, 21, 18> M;
+    Eigen::Matrix<Scalar, 21, 1> b;
+    auto assemble = [&](const Matrix4& X, const Matrix4& Y, const Matrix4& Z,
+                        Eigen::Matrix<Scalar, 18, 18>& MtM, Eigen::Matrix<Scalar, 18, 1>& Mtb,
+                        bool dump) {
+        Matrix4 Yinv = SE3inv(Y);
+        MtM.setZero();
+        Mtb.setZero();
+        Scalar res = 0;
+        if (dump) {
+            M_full->resize(21 * (Ni + Nj), 18);
+            b_full->resize(21 * (Ni + Nj), 1);
+        }
 
         for (int i = 0; i < Ni; i++) {
-            diff1 = (A1_m[i] * Xupdate * B1_m[i] - Yupdate * C1_m[i] * Zupdate).norm();
+            MbMat_1(M, b, stats.A1(i).mean(), X,
+                    stats.B1(i).mean(), Y, stats.C1(i).mean(), Z,
+                    stats.B1(i).cov(), stats.C1(i).cov());
+            MtM.noalias() += w1[i] * M.transpose() * M;
+            Mtb.noalias() += w1[i] * M.transpose() * b;
+            res += w1[i] * b.squaredNorm();
+            if (dump) {
+                M_full->middleRows(21 * i, 21) = (std::sqrt(w1[i]) * M).template cast<double>();
+                b_full->middleRows(21 * i, 21) = (std::sqrt(w1[i]) * b).template cast<double>();
+            }
         }
 
-        for (int i = 0; i < Nj; i++) {
-            diff2 = (A2_m[i] * Xupdate * B2_m[i] - Yupdate * C2_m[i] * Zupdate).norm();
+        for (int j = 0; j < Nj; j++) {
+            MbMat_2(M, b,
+                    stats.C2(j).mean(), Z, stats.B2(j).meanInv(),
+                    Yinv, stats.A2(j).mean(), X,
+                    stats.B2(j).cov(), stats.A2(j).cov(), stats.B2(j).mean());
+            MtM.noalias() += w2[j] * M.transpose() * M;
+            Mtb.noalias() += w2[j] * M.transpose() * b;
+            res += w2[j] * b.squaredNorm();
+            if (dump) {
+                M_full->middleRows(21 * (Ni + j), 21) = (std::sqrt(w2[j]) * M).template cast<double>();
+                b_full->middleRows(21 * (Ni + j), 21) = (std::sqrt(w2[j]) * b).template cast<double>();
+            }
+        }
+        return std::sqrt(res / (N1 + N2));
+    };
+
+    Eigen::Matrix<Scalar, 18, 18> MtM, MtM_try;
+    Eigen::Matrix<Scalar, 18, 1> Mtb, Mtb_try;
+    Scalar residual = assemble(Xupdate, Yupdate, Zupdate, MtM, Mtb, false);
+
+    // Normal-equation residual per sample, zero at a least squares solution
+    auto gradient = [&]() {
+        return Mtb.norm() / (N1 + N2);
+    };
+
+    // The metric is used for the convergence test and to compare damped
+    // steps if it is evaluated every iteration, the residual otherwise
+    bool use_metric = params.metric_every == 1;
+    Scalar diff = use_metric ? error(Xupdate, Yupdate, Zupdate) : residual;
+    bool converged = use_metric ? diff < params.tol : gradient() < params.tol;
+    Scalar metric_last = diff;
+    int metric_num = use_metric ? num : -1;
+    Scalar lambda = params.lambda_init;
+    Scalar radius = params.radius_init;
+
+    while (xi.norm() >= params.tol && !converged && num <= params.max_num) {
+        if (M_full) {
+            assemble(Xupdate, Yupdate, Zupdate, MtM_try, Mtb_try, true);
         }
 
-        Eigen::VectorXd w_X = xi_new.block(0, 0, 3, 1);
-        Eigen::VectorXd v_X = xi_new.block(3, 0, 3, 1);
-        Eigen::VectorXd w_Y = xi_new.block(6, 0, 3, 1);
-        Eigen::VectorXd v_Y = xi_new.block(9, 0, 3, 1);
-        Eigen::VectorXd w_Z = xi_new.block(12, 0, 3, 1);
-        Eigen::VectorXd v_Z = xi_new.block(15, 0, 3, 1);
-
-        Eigen::Matrix4d X_hat;
-        X_hat << skew(w_X), v_X,
-                Eigen::RowVector4d::Zero();
+        // Inversion to get xi_X, xi_Y, xi_Z
+        if (params.method == AxbyczProb3Params::GaussNewton) {
+            xi = MtM.ldlt().solve(Mtb);
+
+            X_cal = Xupdate * se3Exp(xi.template block<6, 1>(0, 0));
+            Y_cal = Yupdate * se3Exp(xi.template block<6, 1>(6, 0));
+            Z_cal = Zupdate * se3Exp(xi.template block<6, 1>(12, 0));
+
+            // Update
+            Xupdate = X_cal;
+            Yupdate = Y_cal;
+            Zupdate = Z_cal;
+            residual = assemble(Xupdate, Yupdate, Zupdate, MtM, Mtb, false);
+        } else {
+            // Damped step, accepted only if it decreases the cost
+            Scalar cost_now = use_metric ? diff : residual;
+            bool accepted = false;
+            for (int trial = 0; trial < params.max_trials && !accepted; ++trial) {
+                Eigen::Matrix<Scalar, 18, 1> step;
+                if (params.method == AxbyczProb3Params::LevenbergMarquardt) {
+                    Eigen::Matrix<Scalar, 18, 18> MtM_damped = MtM;
+                    MtM_damped.diagonal() += lambda * (MtM.diagonal().array() + Scalar(1e-12)).matrix();
+                    step = MtM_damped.ldlt().solve(Mtb);
+                } else {
+                    step = doglegStep(MtM, Mtb, radius);
+                }
+
+                Matrix4 X_try = Xupdate * se3Exp(step.template block<6, 1>(0, 0));
+                Matrix4 Y_try = Yupdate * se3Exp(step.template block<6, 1>(6, 0));
+                Matrix4 Z_try = Zupdate * se3Exp(step.template block<6, 1>(12, 0));
+                Scalar residual_try = assemble(X_try, Y_try, Z_try, MtM_try, Mtb_try, false);
+                Scalar diff_try = use_metric ? error(X_try, Y_try, Z_try) : residual_try;
+
+                if (diff_try < cost_now) {
+                    accepted = true;
+                    xi = step;
+                    X_cal = Xupdate = X_try;
+                    Y_cal = Yupdate = Y_try;
+                    Z_cal = Zupdate = Z_try;
+                    MtM = MtM_try;
+                    Mtb = Mtb_try;
+                    residual = residual_try;
+                    if (use_metric) {
+                        diff = diff_try;
+                    }
+                    lambda *= params.lambda_down;
+                    radius = std::max(radius, 2 * step.norm());
+                } else {
+                    lambda *= params.lambda_up;
+                    radius *= 0.5;
+                }
+            }
+
+            // No step within the trial budget decreases the cost
+            if (!accepted) {
+                ++num;
+                break;
+            }
+        }
 
-        Eigen::Matrix4d Y_hat;
-        Y_hat << skew(w_Y), v_Y,
-                Eigen::RowVector4d::Zero();
+        ++num;
 
-        Eigen::Matrix4d Z_hat;
-        Z_hat << skew(w_Z), v_Z,
-                Eigen::RowVector4d::Zero();
+        // Error
+        if (use_metric) {
+            if (params.method == AxbyczProb3Params::GaussNewton) {
+                diff = error(Xupdate, Yupdate, Zupdate);
+            }
+            converged = diff < params.tol;
+            metric_last = diff;
+            metric_num = num;
+        } else {
+            diff = residual;
+            converged = gradient() < params.tol;
+            if (params.metric_every > 0 && num % params.metric_every == 0) {
+                metric_last = error(Xupdate, Yupdate, Zupdate);
+                metric_num = num;
+                converged = converged || metric_last < params.tol;
+            }
+        }
 
-        X_cal = Xupdate * (X_hat).exp();
-        Y_cal = Yupdate * (Y_hat).exp();
-        Z_cal = Zupdate * (Z_hat).exp();
+        if (params.keep_going && !params.keep_going(num, diff)) {
+            break;
+        }
+    }
 
-        // Update
-        Xupdate = X_cal;
-        Yupdate = Y_cal;
-        Zupdate = Z_cal;
+    // Metric at the returned solution, evaluated once at termination
+    // unless the last iteration already did
+    if (cost) {
+        *cost = metric_num == num ? metric_last : error(Xupdate, Yupdate, Zupdate);
+    }
+}
 
-        ++num;
+template <typename Sequence, typename Scalar>
+void axbyczProb3(const std::vector<Sequence> &A1,
+                 const std::vector<Sequence> &B1,
+                 const std::vector<Sequence> &C1,
+                 const std::vector<Sequence> &A2,
+                 const std::vector<Sequence> &B2,
+                 const std::vector<Sequence> &C2,
+                 const Eigen::Matrix<Scalar, 4, 4> &Xinit,
+                 const Eigen::Matrix<Scalar, 4, 4> &Yinit,
+                 const Eigen::Matrix<Scalar, 4, 4> &Zinit,
+                 Eigen::Matrix<Scalar, 4, 4> &X_cal,
+                 Eigen::Matrix<Scalar, 4, 4> &Y_cal,
+                 Eigen::Matrix<Scalar, 4, 4> &Z_cal,
+                 int& num,
+                 const AxbyczProb3Params &params = AxbyczProb3Params(),
+                 Eigen::MatrixXd *M_full = nullptr,
+                 Eigen::MatrixXd *b_full = nullptr,
+                 Scalar *cost = nullptr) {
+    // Calculate mean and covariance of each cluster once
+    AxbyczProb3Stats<Scalar> stats(A1, B1, C1, A2, B2, C2);
+    axbyczProb3(stats, Xinit, Yinit, Zinit, X_cal, Y_cal, Z_cal, num, params, M_full, b_full, cost);
+}
 
-        // Error
-        diff = metric(A1,B1,C1,Xupdate,Yupdate,Zupdate) +
-               metric(A2,B2,C2,Xupdate,Yupdate,Zupdate);
+// Data recorded at a single fixed A pose and a single fixed C pose
+template <typename Scalar>
+void axbyczProb3(const std::vector<Eigen::Matrix4d> &A1,
+                 const std::vector<Eigen::Matrix4d> &B1,
+                 const std::vector<Eigen::Matrix4d> &C1,
+                 const std::vector<Eigen::Matrix4d> &A2,
+                 const std::vector<Eigen::Matrix4d> &B2,
+                 const std::vector<Eigen::Matrix4d> &C2,
+                 const Eigen::Matrix<Scalar, 4, 4> &Xinit,
+                 const Eigen::Matrix<Scalar, 4, 4> &Yinit,
+                 const Eigen::Matrix<Scalar, 4, 4> &Zinit,
+                 Eigen::Matrix<Scalar, 4, 4> &X_cal,
+                 Eigen::Matrix<Scalar, 4, 4> &Y_cal,
+                 Eigen::Matrix<Scalar, 4, 4> &Z_cal,
+                 int& num,
+                 const AxbyczProb3Params &params = AxbyczProb3Params(),
+                 Eigen::MatrixXd *M_full = nullptr,
+                 Eigen::MatrixXd *b_full = nullptr,
+                 Scalar *cost = nullptr) {
+    typedef std::vector<std::vector<Eigen::Matrix4d>> Clusters;
+    axbyczProb3(Clusters(1, A1), Clusters(1, B1), Clusters(1, C1),
+                Clusters(1, A2), Clusters(1, B2), Clusters(1, C2),
+                Xinit, Yinit, Zinit, X_cal, Y_cal, Z_cal, num, params, M_full, b_full, cost);
+}
 
-    }
+// Same, with the data given as single views. Only the index arrays are
+// copied into the clusters.
+template <typename Base, typename Scalar>
+void axbyczProb3(const PermutedPoses<Base> &A1,
+                 const PermutedPoses<Base> &B1,
+                 const PermutedPoses<Base> &C1,
+                 const PermutedPoses<Base> &A2,
+                 const PermutedPoses<Base> &B2,
+                 const PermutedPoses<Base> &C2,
+                 const Eigen::Matrix<Scalar, 4, 4> &Xinit,
+                 const Eigen::Matrix<Scalar, 4, 4> &Yinit,
+                 const Eigen::Matrix<Scalar, 4, 4> &Zinit,
+                 Eigen::Matrix<Scalar, 4, 4> &X_cal,
+                 Eigen::Matrix<Scalar, 4, 4> &Y_cal,
+                 Eigen::Matrix<Scalar, 4, 4> &Z_cal,
+                 int& num,
+                 const AxbyczProb3Params &params = AxbyczProb3Params(),
+                 Eigen::MatrixXd *M_full = nullptr,
+                 Eigen::MatrixXd *b_full = nullptr,
+                 Scalar *cost = nullptr) {
+    typedef std::vector<PermutedPoses<Base>> Clusters;
+    axbyczProb3(Clusters(1, A1), Clusters(1, B1), Clusters(1, C1),
+                Clusters(1, A2), Clusters(1, B2), Clusters(1, C2),
+                Xinit, Yinit, Zinit, X_cal, Y_cal, Z_cal, num, params, M_full, b_full, cost);
 }
 
 #endif
\ No newline at end of file
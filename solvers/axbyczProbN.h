@@ -0,0 +1,217 @@
+/*
+DESCRIPTION:
+
+The program implements the probabilistic solvers for AXB = YCZ for any
+combination of data collection modes. The data is given as a list of
+fixture groups, each recorded while one of A, B or C is held at a fixed
+pose and the other two vary:
+
+  A fixed: C_i Z = (Y^{-1} A X) B_i,            an AX = YB problem for Z
+  C fixed: A_i X = (Y C Z) B_i^{-1},            an AX = YB problem for X
+  B fixed: C_i^{-1} Y^{-1} = (Z B^{-1} X^{-1}) A_i^{-1},
+                                                an AX = YB problem for Y^{-1}
+
+The statistics of the two varying sequences of every group are computed
+once when the group is built, and batchSolveXY gives the proper candidates of the unknown the
+group determines. Groups with the same fixed pose add to the same
+candidate set. Without a B-fixed group, every pair of X and Z candidates yields
+one consistent Y candidate per group, as in axbyczProb1.
+
+Every (X, Y, Z) combination is scored in one pass over all groups with
+the cost sum_g |rotError + weight * tranError| of
+\bar{A}_g X \bar{B}_g = Y \bar{C}_g Z, where the fixed pose of the group
+replaces its mean. The parts of this cost that do not depend on Y are
+computed once per X and Z candidate.
+
+axbyczProb1 (A1 and C2 fixed) and axbyczProb2 (A1, C2 and B3 fixed) are
+thin wrappers that build the groups. Another data collection mode only
+needs another list of groups.
+
+The search runs in the scalar type of the groups: FixtureGroup and
+XYZCandidate for double, FixtureGroupf and XYZCandidatef for float.
+
+Input:
+    groups: fixture groups
+    opt: bool
+    nstd1, nstd2: standard deviation
+    weight: weight on the translational error of the cost function
+    num_candidates: number of combinations to keep
+Output:
+    candidates: the num_candidates combinations with the smallest cost
+    returns the number of candidates, 0 without an A-fixed or a C-fixed
+    group
+*/
+
+#ifndef AXBYCZPROBN_H
+#define AXBYCZPROBN_H
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <array>
+#include <eigen3/Eigen/Dense>
+#include "batchSolveXY.h"
+#include "rotError.h"
+#include "tranError.h"
+#include "poseStats.h"
+#include "SE3.h"
+
+// One combination of X, Y and Z candidates and its cost
+template <typename Scalar>
+struct XYZCandidateT {
+    Eigen::Matrix<Scalar, 4, 4> X, Y, Z;
+    Scalar cost;
+};
+
+typedef XYZCandidateT<double> XYZCandidate;
+typedef XYZCandidateT<float> XYZCandidatef;
+
+// Insert c into candidates, which holds at most k entries sorted by
+// ascending cost. With k <= 0 nothing is kept.
+template <typename Scalar>
+void keepBestCandidates(std::vector<XYZCandidateT<Scalar>>& candidates,
+                        int k,
+                        const XYZCandidateT<Scalar>& c) {
+    if (k <= 0) {
+        return;
+    }
+    if (static_cast<int>(candidates.size()) == k && c.cost >= candidates.back().cost) {
+        return;
+    }
+    auto it = std::upper_bound(candidates.begin(), candidates.end(), c,
+                               [](const XYZCandidateT<Scalar>& a, const XYZCandidateT<Scalar>& b) {
+                                   return a.cost < b.cost;
+                               });
+    candidates.insert(it, c);
+    if (static_cast<int>(candidates.size()) > k) {
+        candidates.pop_back();
+    }
+}
+
+// Which of A, B and C is held at a fixed pose in a fixture group
+enum class FixedPose { A, B, C };
+
+// Data of one fixture group, reduced to the statistics of its three
+// sequences when the group is built. The fixed pose is taken from the
+// first sample, with zero covariance. The sequences may be any type with
+// size() and X[i], e.g. vectors of Matrix4d or CompactPoses.
+template <typename Scalar>
+struct FixtureGroupT {
+    template <typename Sequence>
+    FixtureGroupT(FixedPose fixed,
+                  const Sequence& A,
+                  const Sequence& B,
+                  const Sequence& C)
+        : fixed(fixed),
+          statsA(stats(fixed == FixedPose::A, A)),
+          statsB(stats(fixed == FixedPose::B, B)),
+          statsC(stats(fixed == FixedPose::C, C)) {}
+
+    FixedPose fixed;
+    PoseStatsT<Scalar> statsA, statsB, statsC;
+
+private:
+    template <typename Sequence>
+    static PoseStatsT<Scalar> stats(bool is_fixed, const Sequence& X) {
+        if (is_fixed) {
+            return PoseStatsT<Scalar>(X[0].template cast<Scalar>(), Eigen::Matrix<Scalar, 6, 6>::Zero());
+        }
+        return PoseStatsT<Scalar>(X);
+    }
+};
+
+typedef FixtureGroupT<double> FixtureGroup;
+typedef FixtureGroupT<float> FixtureGroupf;
+
+// Append the first n candidates, inverted if requested
+template <typename Scalar>
+void appendCandidates(const std::array<Eigen::Matrix<Scalar, 4, 4>, 8>& X_g,
+                      int n,
+                      bool invert,
+                      std::vector<Eigen::Matrix<Scalar, 4, 4>>& X) {
+    for (int k = 0; k < n; ++k) {
+        X.push_back(invert ? SE3inv(X_g[k]) : X_g[k]);
+    }
+}
+
+template <typename Scalar>
+int axbyczProbN(const std::vector<FixtureGroupT<Scalar>>& groups,
+                bool opt,
+                double nstd1,
+                double nstd2,
+                double weight,
+                int num_candidates,
+                std::vector<XYZCandidateT<Scalar>>& candidates) {
+
+    typedef Eigen::Matrix<Scalar, 4, 4> Matrix4;
+
+    candidates.clear();
+    int G = groups.size();
+
+    //// Representative poses of each group: the fixed pose and the means
+    //// of the varying sequences, and the candidates each group yields
+    std::vector<Matrix4> A_bar(G), B_bar(G), C_bar(G);
+    std::vector<Matrix4> X, Y, Z;
+    std::array<Matrix4, 8> X_g, Y_dummy;
+
+    for (int g = 0; g < G; ++g) {
+        const FixtureGroupT<Scalar>& group = groups[g];
+        A_bar[g] = group.statsA.mean();
+        B_bar[g] = group.statsB.mean();
+        C_bar[g] = group.statsC.mean();
+        int n;
+
+        if (group.fixed == FixedPose::A) {
+            n = batchSolveXY(group.statsC, group.statsB, opt, nstd1, nstd2, X_g, Y_dummy, true);
+            appendCandidates(X_g, n, false, Z);
+        } else if (group.fixed == FixedPose::C) {
+            n = batchSolveXY(group.statsA, group.statsB.inverse(), opt, nstd1, nstd2, X_g, Y_dummy, true);
+            appendCandidates(X_g, n, false, X);
+        } else {
+            n = batchSolveXY(group.statsC.inverse(), group.statsA.inverse(), opt, nstd1, nstd2, X_g, Y_dummy, true);
+            appendCandidates(X_g, n, true, Y);
+        }
+    }
+
+    // At least one A-fixed and one C-fixed group are required
+    if (X.empty() || Z.empty()) {
+        return 0;
+    }
+
+    //// Score every (X, Y, Z) combination
+    std::vector<Matrix4> left(G), CZ(G);
+    std::vector<Matrix4> Y_candidate;
+    Scalar w = weight;
+
+    for (size_t i = 0; i < X.size(); ++i) {
+        for (int g = 0; g < G; ++g) {
+            left[g] = A_bar[g] * X[i] * B_bar[g];
+        }
+
+        for (size_t p = 0; p < Z.size(); ++p) {
+            for (int g = 0; g < G; ++g) {
+                CZ[g] = C_bar[g] * Z[p];
+            }
+
+            // Without a B-fixed group, each group determines one Y
+            if (Y.empty()) {
+                Y_candidate.clear();
+                for (int g = 0; g < G; ++g) {
+                    Y_candidate.push_back(left[g] * SE3inv(CZ[g]));
+                }
+            }
+
+            for (const auto& Y_j : Y.empty() ? Y_candidate : Y) {
+                Scalar cost = 0;
+                for (int g = 0; g < G; ++g) {
+                    Matrix4 right = Y_j * CZ[g];
+                    cost += std::abs(rotError(left[g], right) + w * tranError(left[g], right));
+                }
+                keepBestCandidates(candidates, num_candidates, {X[i], Y_j, Z[p], cost});
+            }
+        }
+    }
+    return candidates.size();
+}
+
+#endif
@@ -30,6 +30,24 @@ Output:
     X, Y: Matrices - dim - 4x4
     MeanA, MeanB: Matrices - dim - 4x4 - Mean of A, B
     SigA, SigB: Matrices - dim - 6x6 - Covariance of A, B
+
+The statistics can also come from MeanCovAccumulator objects when A and
+B are streamed, or from PoseStats objects computed once and shared
+between several calls, and batchSolveXYFromMeanCov solves from means
+and covariances that were computed elsewhere.
+
+For many independent datasets, e.g. one per robot cell, the PoseBatch
+overload computes the statistics of all of them in one vectorized pass.
+
+The 3x3 eigenproblems and the candidates use fixed-size types. The
+std::array overloads do not allocate, and with proper_only set they
+only build the 4 candidates whose rotation has determinant 1, which
+are the only ones the solvers use.
+
+All versions except the MeanCovAccumulator and PoseBatch ones work in
+float as well as in double, in the scalar type of their pose arguments.
+A and B may be any sequence with size() and A[i], e.g. vectors of
+Matrix4d, CompactPoses or PermutedPoses views.
 */
 
 #ifndef BATCHSOLVEXY_H
@@ -37,37 +55,144 @@ Output:
 
 #include <iostream>
 #include <algorithm>
+#include <array>
 #include <vector>
 #include <Eigen/Eigenvalues>
 #include "meanCov.h"
+#include "meanCovAccumulator.h"
+#include "poseStats.h"
+#include "poseBatch.h"
 #include "so3Vec.h"
+#include "SE3.h"
+
+// Sort the eigenvalues in ascending order, and the eigenvectors with them
+template <typename Scalar>
+void sortEigenVectors(Eigen::Matrix<Scalar, 3, 1>& eigenvalues,
+                      Eigen::Matrix<Scalar, 3, 3>& eigenvectors) {
+    for (int i = 1; i < 3; ++i) {
+        for (int j = i; j > 0 && eigenvalues[j] < eigenvalues[j - 1]; --j) {
+            std::swap(eigenvalues[j], eigenvalues[j - 1]);
+            eigenvectors.col(j).swap(eigenvectors.col(j - 1));
+        }
+    }
+}
 
-// Sorting function
-void sortEigenVectors(const Eigen::VectorXd& eigenvalues,
-                      const Eigen::MatrixXd& eigenvectors,
-                      Eigen::VectorXd& sorted_eigenvalues,
-                      Eigen::MatrixXd& sorted_eigenvectors) {
-    // Create a vector of pairs (eigenvalue, eigenvector)
-    std::vector<std::pair<double, Eigen::VectorXd>> eigen_pairs(eigenvalues.size());
+// Solve for the X, Y candidates from already computed means and
+// covariances. Writes the 8 candidates, or only the 4 whose rotation is
+// proper if proper_only is set, to the front of X and Y and returns
+// their number.
+template <typename Scalar>
+int batchSolveXYFromMeanCov(bool opt,
+                            double nstd_A,
+                            double nstd_B,
+                            std::array<Eigen::Matrix<Scalar, 4, 4>, 8> &X,
+                            std::array<Eigen::Matrix<Scalar, 4, 4>, 8> &Y,
+                            const Eigen::Matrix<Scalar, 4, 4> &MeanA,
+                            const Eigen::Matrix<Scalar, 4, 4> &MeanB,
+                            Eigen::Matrix<Scalar, 6, 6> &SigA,
+                            Eigen::Matrix<Scalar, 6, 6> &SigB,
+                            bool proper_only = false) {
 
-    for (size_t i = 0; i < eigenvalues.size(); ++i) {
-        eigen_pairs[i] = std::make_pair(eigenvalues[i], eigenvectors.col(i));
+    typedef Eigen::Matrix<Scalar, 3, 3> Matrix3;
+    typedef Eigen::Matrix<Scalar, 3, 1> Vector3;
+
+    // update SigA and SigB if nstd_A and nstd_B are known
+    if (opt) {
+        SigA -= Scalar(nstd_A) * Eigen::Matrix<Scalar, 6, 6>::Identity();
+        SigB -= Scalar(nstd_B) * Eigen::Matrix<Scalar, 6, 6>::Identity();
     }
 
-    // Sort the eigen_pairs based on eigenvalues
-    std::sort(eigen_pairs.begin(), eigen_pairs.end(), [](const std::pair<double, Eigen::VectorXd>& a, const std::pair<double, Eigen::VectorXd>& b) {
-        return a.first < b.first;
-    });
+    // Eigenvectors of the rotational blocks, sorted by eigenvalue
+    Eigen::SelfAdjointEigenSolver<Matrix3> esA(SigA.template block<3, 3>(0, 0));
+    Vector3 eigenvalues_A = esA.eigenvalues();
+    Matrix3 VA = esA.eigenvectors();
+    sortEigenVectors(eigenvalues_A, VA);
+
+    Eigen::SelfAdjointEigenSolver<Matrix3> esB(SigB.template block<3, 3>(0, 0));
+    Vector3 eigenvalues_B = esB.eigenvalues();
+    Matrix3 VB = esB.eigenvectors();
+    sortEigenVectors(eigenvalues_B, VB);
+
+    // There are eight possibilities for Rx = VA * Q * VB^T, with Q one of
+    // the diagonal sign matrices below or their negatives. Q1..Q4 have
+    // determinant 1, so Rx is proper for Q1..Q4 if det(VA) = det(VB), and
+    // for -Q1..-Q4 otherwise.
+    static const Vector3 Q[4] = {
+            Vector3(1, 1, 1),
+            Vector3(-1, -1, 1),
+            Vector3(-1, 1, -1),
+            Vector3(1, -1, -1)};
+    bool same_handedness = VA.determinant() * VB.determinant() > 0;
+
+    Matrix3 SigA_11 = SigA.template block<3, 3>(0, 0);
+    Matrix3 SigA_12 = SigA.template block<3, 3>(0, 3);
+    Matrix3 SigB_12 = SigB.template block<3, 3>(0, 3);
+    Eigen::Matrix<Scalar, 4, 4> MeanB_inv = SE3inv(MeanB);
 
-    // Fill the sorted_eigenvalues and sorted_eigenvectors with the sorted data
-    for (size_t i = 0; i < eigen_pairs.size(); ++i) {
-        sorted_eigenvalues[i] = eigen_pairs[i].first;
-        sorted_eigenvectors.col(i) = eigen_pairs[i].second;
+    int n = 0;
+    for (int i = 0; i < 8; ++i) {
+        Scalar sign = i < 4 ? 1 : -1;
+        if (proper_only && (sign > 0) != same_handedness) {
+            continue;
+        }
+
+        Matrix3 Rx = sign * VA * Q[i % 4].asDiagonal() * VB.transpose();
+        Matrix3 temp = (Rx.transpose() * SigA_11 * Rx).inverse() *
+                       (SigB_12 - Rx.transpose() * SigA_12 * Rx);
+
+        Vector3 tx = -Rx * so3Vec(temp.transpose());
+
+        X[n] << Rx, tx, Eigen::Matrix<Scalar, 1, 3>::Zero(), 1;
+        Y[n] = MeanA * X[n] * MeanB_inv;
+        ++n;
     }
+    return n;
+}
+
+// Same as above, with the candidates returned in vectors
+template <typename Scalar>
+void batchSolveXYFromMeanCov(bool opt,
+                             double nstd_A,
+                             double nstd_B,
+                             std::vector<Eigen::Matrix<Scalar, 4, 4>> &X,
+                             std::vector<Eigen::Matrix<Scalar, 4, 4>> &Y,
+                             const Eigen::Matrix<Scalar, 4, 4> &MeanA,
+                             const Eigen::Matrix<Scalar, 4, 4> &MeanB,
+                             Eigen::Matrix<Scalar, 6, 6> &SigA,
+                             Eigen::Matrix<Scalar, 6, 6> &SigB) {
+
+    std::array<Eigen::Matrix<Scalar, 4, 4>, 8> X_candidate, Y_candidate;
+    int n = batchSolveXYFromMeanCov(opt, nstd_A, nstd_B, X_candidate, Y_candidate,
+                                    MeanA, MeanB, SigA, SigB);
+
+    X.assign(X_candidate.begin(), X_candidate.begin() + n);
+    Y.assign(Y_candidate.begin(), Y_candidate.begin() + n);
 }
 
-void batchSolveXY(const std::vector<Eigen::Matrix4d> &A,
-                  const std::vector<Eigen::Matrix4d> &B,
+template <typename Sequence, typename Scalar>
+void batchSolveXY(const Sequence &A,
+                  const Sequence &B,
+                  bool opt,
+                  double nstd_A,
+                  double nstd_B,
+                  std::vector<Eigen::Matrix<Scalar, 4, 4>> &X,
+                  std::vector<Eigen::Matrix<Scalar, 4, 4>> &Y,
+                  Eigen::Matrix<Scalar, 4, 4> &MeanA,
+                  Eigen::Matrix<Scalar, 4, 4> &MeanB,
+                  Eigen::Matrix<Scalar, 6, 6> &SigA,
+                  Eigen::Matrix<Scalar, 6, 6> &SigB) {
+
+    // Calculate mean and covariance for A and B
+    meanCov(A, MeanA, SigA);
+    meanCov(B, MeanB, SigB);
+
+    batchSolveXYFromMeanCov(opt, nstd_A, nstd_B, X, Y, MeanA, MeanB, SigA, SigB);
+}
+
+// Same as above, with the statistics of streamed A and B data taken from
+// running accumulators instead of recomputed from the full data set
+void batchSolveXY(MeanCovAccumulator &A,
+                  MeanCovAccumulator &B,
                   bool opt,
                   double nstd_A,
                   double nstd_B,
@@ -78,75 +203,77 @@ void batchSolveXY(const std::vector<Eigen::Matrix4d> &A,
                   Eigen::Matrix<double, 6, 6> &SigA,
                   Eigen::Matrix<double, 6, 6> &SigB) {
 
-    std::vector<Eigen::Matrix4d> X_candidate(8, Eigen::Matrix4d::Zero());
-    std::vector<Eigen::Matrix4d> Y_candidate(8, Eigen::Matrix4d::Zero());
+    A.snapshot(MeanA, SigA);
+    B.snapshot(MeanB, SigB);
 
-    // Calculate mean and covariance for A and B
-    meanCov(A, MeanA, SigA);
-    meanCov(B, MeanB, SigB);
+    batchSolveXYFromMeanCov(opt, nstd_A, nstd_B, X, Y, MeanA, MeanB, SigA, SigB);
+}
 
-    // update SigA and SigB if nstd_A and nstd_B are known
-    if (opt) {
-        SigA -= nstd_A * Eigen::MatrixXd::Identity(6, 6);
-        SigB -= nstd_B * Eigen::MatrixXd::Identity(6, 6);
-    }
+// Same as above, with precomputed statistics of A and B. The cached
+// statistics are copied, so opt does not modify them.
+template <typename Scalar>
+void batchSolveXY(const PoseStatsT<Scalar> &A,
+                  const PoseStatsT<Scalar> &B,
+                  bool opt,
+                  double nstd_A,
+                  double nstd_B,
+                  std::vector<Eigen::Matrix<Scalar, 4, 4>> &X,
+                  std::vector<Eigen::Matrix<Scalar, 4, 4>> &Y) {
 
-    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> esA(SigA.block<3, 3>(0, 0));
-    Eigen::MatrixXd VA = esA.eigenvectors().real();
-    Eigen::VectorXcd eigenvalues_A = esA.eigenvalues(); // Eigenvalues for SigA block
-
-    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> esB(SigB.block<3, 3>(0, 0));
-    Eigen::MatrixXd VB = esB.eigenvectors().real();
-    Eigen::VectorXcd eigenvalues_B = esB.eigenvalues(); // Eigenvalues for SigB block
-
-    Eigen::VectorXd real_eigenvalues_A = eigenvalues_A.real();
-    Eigen::VectorXd real_eigenvalues_B = eigenvalues_B.real();
-
-    // Sort eigenvalues and eigenvectors for SigA block
-    Eigen::MatrixXd sorted_VA(3, 3);
-    Eigen::VectorXd sorted_eigenvalues_A(3);
-    sortEigenVectors(real_eigenvalues_A, VA, sorted_eigenvalues_A, sorted_VA);
-
-    // Sort eigenvalues and eigenvectors for SigB block
-    Eigen::MatrixXd sorted_VB(3, 3);
-    Eigen::VectorXd sorted_eigenvalues_B(3);
-    sortEigenVectors(real_eigenvalues_B, VB, sorted_eigenvalues_B, sorted_VB);
-
-    // Define Q matrices
-    Eigen::Matrix3d Q1, Q2, Q3, Q4;
-    Q1 = Eigen::Matrix3d::Identity();
-    Q2 = (Eigen::Matrix3d() << -1, 0, 0, 0, -1, 0, 0, 0, 1).finished();
-    Q3 = (Eigen::Matrix3d() << -1, 0, 0, 0, 1, 0, 0, 0, -1).finished();
-    Q4 = (Eigen::Matrix3d() << 1, 0, 0, 0, -1, 0, 0, 0, -1).finished();
-
-    std::vector<Eigen::Matrix3d> Rx_solved(8, Eigen::Matrix3d::Zero());
-
-    // There are eight possibilities for Rx
-    Rx_solved[0] = sorted_VA * Q1 * sorted_VB.transpose();
-    Rx_solved[1] = sorted_VA * Q2 * sorted_VB.transpose();
-    Rx_solved[2] = sorted_VA * Q3 * sorted_VB.transpose();
-    Rx_solved[3] = sorted_VA * Q4 * sorted_VB.transpose();
-    Rx_solved[4] = sorted_VA * (-Q1) * sorted_VB.transpose();
-    Rx_solved[5] = sorted_VA * (-Q2) * sorted_VB.transpose();
-    Rx_solved[6] = sorted_VA * (-Q3) * sorted_VB.transpose();
-    Rx_solved[7] = sorted_VA * (-Q4) * sorted_VB.transpose();
-
-    X.resize(8);
-    Y.resize(8);
+    Eigen::Matrix<Scalar, 6, 6> SigA = A.cov();
+    Eigen::Matrix<Scalar, 6, 6> SigB = B.cov();
 
-    for (int i = 0; i < 8; ++i) {
-        Eigen::Matrix3d temp = (Rx_solved[i].transpose() * SigA.block<3, 3>(0, 0) * Rx_solved[i]).inverse() *
-                               (SigB.block<3, 3>(0, 3) - Rx_solved[i].transpose() * SigA.block<3, 3>(0, 3) * Rx_solved[i]);
+    batchSolveXYFromMeanCov(opt, nstd_A, nstd_B, X, Y, A.mean(), B.mean(), SigA, SigB);
+}
 
-        Eigen::Vector3d tx = -Rx_solved[i] * so3Vec(temp.transpose());
+// Same as above, without allocations: the candidates are written to the
+// front of X and Y and their number is returned
+template <typename Scalar>
+int batchSolveXY(const PoseStatsT<Scalar> &A,
+                 const PoseStatsT<Scalar> &B,
+                 bool opt,
+                 double nstd_A,
+                 double nstd_B,
+                 std::array<Eigen::Matrix<Scalar, 4, 4>, 8> &X,
+                 std::array<Eigen::Matrix<Scalar, 4, 4>, 8> &Y,
+                 bool proper_only = false) {
 
-        X_candidate[i] << Rx_solved[i], tx, Eigen::Vector3d::Zero().transpose(), 1;
-        Y_candidate[i] = MeanA * X_candidate[i] * MeanB.inverse();
+    Eigen::Matrix<Scalar, 6, 6> SigA = A.cov();
+    Eigen::Matrix<Scalar, 6, 6> SigB = B.cov();
+
+    return batchSolveXYFromMeanCov(opt, nstd_A, nstd_B, X, Y, A.mean(), B.mean(), SigA, SigB,
+                                   proper_only);
+}
+
+// Same as above for K independent datasets of A and B stored in
+// PoseBatch objects. The means and covariances of all datasets are
+// computed together, and the candidates of dataset k are written to X[k]
+// and Y[k]. Returns the number of candidates per dataset.
+int batchSolveXY(const PoseBatch &A,
+                 const PoseBatch &B,
+                 bool opt,
+                 double nstd_A,
+                 double nstd_B,
+                 std::vector<std::array<Eigen::Matrix4d, 8>> &X,
+                 std::vector<std::array<Eigen::Matrix4d, 8>> &Y,
+                 std::vector<Eigen::Matrix4d> &MeanA,
+                 std::vector<Eigen::Matrix4d> &MeanB,
+                 std::vector<Eigen::Matrix<double, 6, 6>> &SigA,
+                 std::vector<Eigen::Matrix<double, 6, 6>> &SigB,
+                 bool proper_only = false) {
+
+    meanCov(A, MeanA, SigA);
+    meanCov(B, MeanB, SigB);
 
-        // Set the output X and Y
-        X[i] = X_candidate[i];
-        Y[i] = Y_candidate[i];
+    int K = A.datasets();
+    int n = 0;
+    X.resize(K);
+    Y.resize(K);
+    for (int k = 0; k < K; ++k) {
+        n = batchSolveXYFromMeanCov(opt, nstd_A, nstd_B, X[k], Y[k],
+                                    MeanA[k], MeanB[k], SigA[k], SigB[k], proper_only);
     }
+    return n;
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -69,8 +69,8 @@ std::tuple<Eigen::Matrix4d, Eigen::Matrix4d, Eigen::Matrix4d, int> Wang_AXBYCZ(c
     }
 
     double e = M_PI / 5;
-    Eigen::Matrix3d RX_init = skewExp(so3Vec(Eigen::Vector3d::Constant(e))) * Xact.block<3, 3>(0, 0);
-    Eigen::Matrix3d RZ_init = skewExp(so3Vec(Eigen::Vector3d::Constant(e))) * Zact.block<3, 3>(0, 0);
+    Eigen::Matrix3d RX_init = skewExp(Eigen::Vector3d::Constant(e)) * Xact.block<3, 3>(0, 0);
+    Eigen::Matrix3d RZ_init = skewExp(Eigen::Vector3d::Constant(e)) * Zact.block<3, 3>(0, 0);
     Eigen::Matrix3d RY_init = RA[0] * RX_init * RB[0] / RZ_init / RC[0];
 
     Eigen::VectorXd delR = 10000 * Eigen::VectorXd::Ones(9);
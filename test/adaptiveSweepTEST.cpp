@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+#include "adaptiveSweep.h"
+
+// Trials of rate rk are normal with mean 1 and standard deviation sigma[rk]
+std::vector<RunningStats> runAdaptive(int num_threads, const std::vector<double> &sigma,
+                                      const AdaptiveSweepParams &params, Eigen::MatrixXi &runs) {
+    runs = Eigen::MatrixXi::Zero(sigma.size(), params.max_trials);
+    ThreadPool pool(num_threads);
+    return adaptiveSweep(pool, 11, sigma.size(), [&](const SweepCell &cell) {
+        RngStream rng = cell.stream(RngPurpose::Data);
+        runs(cell.rate, cell.trial) += 1;
+        return std::vector<double>{1.0 + sigma[cell.rate] * rng.normal(), 2.0};
+    }, params, nullptr);
+}
+
+TEST(AdaptiveSweepTest, RunningStatsMatchesTwoPass) {
+    Eigen::MatrixXd X = Eigen::MatrixXd::Random(3, 17);
+    RunningStats stats;
+    for (int i = 0; i < X.cols(); ++i) {
+        stats.add(X.col(i));
+    }
+    Eigen::VectorXd mean = X.rowwise().mean();
+    Eigen::VectorXd var = (X.colwise() - mean).rowwise().squaredNorm() / (X.cols() - 1);
+
+    ASSERT_EQ(stats.count(), 17);
+    ASSERT_TRUE(stats.mean().isApprox(mean, 1e-12));
+    ASSERT_TRUE(stats.variance().isApprox(var, 1e-12));
+    ASSERT_TRUE(stats.halfWidth(2.0).isApprox(2.0 * (var / 17).cwiseSqrt(), 1e-12));
+}
+
+TEST(AdaptiveSweepTest, NoisyRatesGetMoreTrials) {
+    std::vector<double> sigma = {0.01, 0.1, 0.2, 5.0};
+    AdaptiveSweepParams params;
+    params.min_trials = 4;
+    params.max_trials = 200;
+    params.rel_tol = 0.05;
+    Eigen::MatrixXi runs;
+    std::vector<RunningStats> stats = runAdaptive(2, sigma, params, runs);
+
+    // Every trial runs once and the trials of a rate are 0, 1, ..., count - 1
+    for (size_t rk = 0; rk < sigma.size(); ++rk) {
+        ASSERT_TRUE((runs.row(rk).head(stats[rk].count()).array() == 1).all());
+        ASSERT_TRUE((runs.row(rk).tail(params.max_trials - stats[rk].count()).array() == 0).all());
+    }
+
+    ASSERT_EQ(stats[0].count(), params.min_trials);
+    ASSERT_LT(stats[0].count(), stats[1].count());
+    ASSERT_LT(stats[1].count(), stats[2].count());
+    ASSERT_EQ(stats[3].count(), params.max_trials);
+    for (int rk = 0; rk < 3; ++rk) {
+        ASSERT_LE(stats[rk].halfWidth()(0), params.rel_tol * std::abs(stats[rk].mean()(0)));
+        ASSERT_NEAR(stats[rk].mean()(0), 1.0, 0.1);
+    }
+}
+
+TEST(AdaptiveSweepTest, ResultsDoNotDependOnThreadsOrResume) {
+    std::vector<double> sigma = {0.05, 0.3, 1.0};
+    AdaptiveSweepParams params;
+    params.max_trials = 60;
+    params.tracked = {0};
+    Eigen::MatrixXi runs;
+    std::vector<RunningStats> serial = runAdaptive(1, sigma, params, runs);
+    std::vector<RunningStats> parallel = runAdaptive(3, sigma, params, runs);
+
+    std::string path = (std::filesystem::temp_directory_path() / "adaptiveSweepTEST.ckpt").string();
+    std::remove(path.c_str());
+    auto cell = [&](const SweepCell &c) {
+        RngStream rng = c.stream(RngPurpose::Data);
+        return std::vector<double>{1.0 + sigma[c.rate] * rng.normal(), 2.0};
+    };
+    ThreadPool pool(2);
+    {
+        SweepCheckpoint checkpoint(path, 1, 11);
+        adaptiveSweep(pool, checkpoint, sigma.size(), cell, params, nullptr);
+    }
+    SweepCheckpoint checkpoint(path, 1, 11);
+    int stored = checkpoint.size();
+    std::vector<RunningStats> resumed = adaptiveSweep(pool, checkpoint, sigma.size(), cell, params, nullptr);
+    ASSERT_EQ(checkpoint.size(), stored);
+    std::remove(path.c_str());
+
+    for (size_t rk = 0; rk < sigma.size(); ++rk) {
+        ASSERT_EQ(serial[rk].count(), parallel[rk].count());
+        ASSERT_TRUE(serial[rk].mean() == parallel[rk].mean());
+        ASSERT_TRUE(serial[rk].variance() == parallel[rk].variance());
+        ASSERT_EQ(serial[rk].count(), resumed[rk].count());
+        ASSERT_TRUE(serial[rk].mean() == resumed[rk].mean());
+    }
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
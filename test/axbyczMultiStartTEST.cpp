@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+#include "axbyczMultiStart.h"
+#include "syntheticData.h"
+
+class AxbyczMultiStartTest : public testing::Test, protected SyntheticData {
+protected:
+    std::vector<XYZCandidate> starts;
+
+    // Noise-free data in three fixed-A and three fixed-C clusters, one
+    // start close to the truth and three far away from it
+    AxbyczMultiStartTest() : SyntheticData(syntheticData(5)) {
+        RngStream rng(5, 1);
+        starts.push_back({X * randomPose(rng, 0.05), Y * randomPose(rng, 0.05),
+                          Z * randomPose(rng, 0.05), 1.0});
+        for (int k = 0; k < 3; ++k) {
+            starts.push_back({randomPose(rng, 3.0), randomPose(rng, 3.0),
+                              randomPose(rng, 3.0), 2.0 + k});
+        }
+    }
+};
+
+TEST_F(AxbyczMultiStartTest, ReturnsBestStart) {
+    ThreadPool pool(2);
+    AxbyczProb3Params params;
+    params.tol = 1e-10;
+    Eigen::Matrix4d X_cal, Y_cal, Z_cal;
+    std::vector<MultiStartResult> results;
+    int k_best = axbyczMultiStart(starts, A1, B1, C1, A2, B2, C2, pool,
+                                  X_cal, Y_cal, Z_cal, results, params, 0.0);
+
+    ASSERT_EQ(results.size(), starts.size());
+    for (size_t k = 0; k < results.size(); ++k) {
+        ASSERT_FALSE(results[k].cancelled);
+        ASSERT_EQ(results[k].prob1_cost, starts[k].cost);
+        ASSERT_GE(results[k].cost, results[k_best].cost);
+    }
+    ASSERT_TRUE(X_cal.isApprox(results[k_best].X));
+    ASSERT_LT((X_cal - X).norm(), 1e-6);
+    ASSERT_LT((Y_cal - Y).norm(), 1e-6);
+    ASSERT_LT((Z_cal - Z).norm(), 1e-6);
+}
+
+TEST_F(AxbyczMultiStartTest, CancelsWorseStarts) {
+    // A single worker runs the starts in order, the good one first
+    ThreadPool pool(1);
+    AxbyczProb3Params params;
+    params.tol = 1e-10;
+    params.max_num = 100;
+    Eigen::Matrix4d X_cal, Y_cal, Z_cal;
+    std::vector<MultiStartResult> results;
+    int k_best = axbyczMultiStart(starts, A1, B1, C1, A2, B2, C2, pool,
+                                  X_cal, Y_cal, Z_cal, results, params, 10.0, 3);
+
+    ASSERT_EQ(k_best, 0);
+    ASSERT_FALSE(results[0].cancelled);
+    for (size_t k = 1; k < results.size(); ++k) {
+        if (results[k].cancelled) {
+            ASSERT_EQ(results[k].num, 3);
+        } else {
+            ASSERT_LT(results[k].cost, 1e-6);
+        }
+    }
+    ASSERT_LT((X_cal - X).norm(), 1e-6);
+    ASSERT_LT((Y_cal - Y).norm(), 1e-6);
+    ASSERT_LT((Z_cal - Z).norm(), 1e-6);
+}
+
+TEST_F(AxbyczMultiStartTest, SharedStatsAcrossThreads) {
+    // All starts read the same cluster statistics concurrently; without
+    // cancellation the result must not depend on the number of workers
+    AxbyczProb3Params params;
+    params.tol = 1e-10;
+    Eigen::Matrix4d X_1, Y_1, Z_1, X_4, Y_4, Z_4;
+    std::vector<MultiStartResult> results_1, results_4;
+    ThreadPool pool_1(1), pool_4(4);
+    int k_1 = axbyczMultiStart(starts, A1, B1, C1, A2, B2, C2, pool_1,
+                               X_1, Y_1, Z_1, results_1, params, 0.0);
+    int k_4 = axbyczMultiStart(starts, A1, B1, C1, A2, B2, C2, pool_4,
+                               X_4, Y_4, Z_4, results_4, params, 0.0);
+
+    ASSERT_EQ(k_1, k_4);
+    for (size_t k = 0; k < starts.size(); ++k) {
+        ASSERT_EQ(results_1[k].num, results_4[k].num);
+        ASSERT_EQ(results_1[k].cost, results_4[k].cost);
+        ASSERT_TRUE(results_1[k].X == results_4[k].X);
+    }
+    ASSERT_TRUE(X_1 == X_4 && Y_1 == Y_4 && Z_1 == Z_4);
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
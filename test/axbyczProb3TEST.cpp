@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+#include "axbyczProb3.h"
+#include "syntheticData.h"
+
+class AxbyczProb3Test : public testing::Test, protected SyntheticData {
+protected:
+    // Draws of the initial guesses and of the noise added by a test
+    RngStream rng;
+
+    // Noise-free data in three fixed-A and three fixed-C clusters
+    AxbyczProb3Test() : SyntheticData(syntheticData(3)), rng(3, 1) {}
+};
+
+TEST_F(AxbyczProb3Test, ConvergesFromNearbyGuess) {
+    Eigen::Matrix4d X_init = X * randomPose(rng, 0.05);
+    Eigen::Matrix4d Y_init = Y * randomPose(rng, 0.05);
+    Eigen::Matrix4d Z_init = Z * randomPose(rng, 0.05);
+
+    AxbyczProb3Params params;
+    params.tol = 1e-10;
+    Eigen::Matrix4d X_cal, Y_cal, Z_cal;
+    int num = 0;
+    axbyczProb3(A1, B1, C1, A2, B2, C2, X_init, Y_init, Z_init,
+                X_cal, Y_cal, Z_cal, num, params);
+
+    ASSERT_LT((X_cal - X).norm(), 1e-6);
+    ASSERT_LT((Y_cal - Y).norm(), 1e-6);
+    ASSERT_LT((Z_cal - Z).norm(), 1e-6);
+}
+
+TEST_F(AxbyczProb3Test, DumpsStackedSystem) {
+    Eigen::Matrix4d X_init = X * randomPose(rng, 1e-3);
+    Eigen::Matrix4d X_cal, Y_cal, Z_cal;
+    Eigen::MatrixXd M, b;
+    int num = 0;
+    axbyczProb3(A1, B1, C1, A2, B2, C2, X_init, Y, Z,
+                X_cal, Y_cal, Z_cal, num, AxbyczProb3Params(), &M, &b);
+
+    ASSERT_EQ(num, 1);
+    ASSERT_EQ(M.rows(), 21 * 6);
+    ASSERT_EQ(M.cols(), 18);
+    ASSERT_EQ(b.rows(), 21 * 6);
+
+    // The least squares solution of the stacked system is the step taken
+    Eigen::VectorXd xi = M.colPivHouseholderQr().solve(b);
+    ASSERT_TRUE((X_init * se3Exp(xi.head<6>())).isApprox(X_cal, 1e-10));
+    ASSERT_TRUE((Z * se3Exp(xi.tail<6>())).isApprox(Z_cal, 1e-10));
+}
+
+TEST_F(AxbyczProb3Test, DampedMethodsConverge) {
+    Eigen::Matrix4d X_init = X * randomPose(rng, 0.8);
+    Eigen::Matrix4d Y_init = Y * randomPose(rng, 0.8);
+    Eigen::Matrix4d Z_init = Z * randomPose(rng, 0.8);
+
+    for (auto method : {AxbyczProb3Params::LevenbergMarquardt, AxbyczProb3Params::Dogleg}) {
+        AxbyczProb3Params params;
+        params.method = method;
+        params.max_num = 50;
+
+        Eigen::Matrix4d X_cal, Y_cal, Z_cal;
+        int num = 0;
+        axbyczProb3(A1, B1, C1, A2, B2, C2, X_init, Y_init, Z_init,
+                    X_cal, Y_cal, Z_cal, num, params);
+
+        ASSERT_LT(num, params.max_num);
+        ASSERT_LT((X_cal - X).norm(), 1e-6);
+        ASSERT_LT((Y_cal - Y).norm(), 1e-6);
+        ASSERT_LT((Z_cal - Z).norm(), 1e-6);
+    }
+}
+
+TEST_F(AxbyczProb3Test, ResidualConvergenceMatchesMetric) {
+    Eigen::Matrix4d X_init = X * randomPose(rng, 0.3);
+    Eigen::Matrix4d Y_init = Y * randomPose(rng, 0.3);
+    Eigen::Matrix4d Z_init = Z * randomPose(rng, 0.3);
+
+    for (int k : {0, 3}) {
+        AxbyczProb3Params params;
+        params.metric_every = k;
+
+        Eigen::Matrix4d X_cal, Y_cal, Z_cal;
+        int num = 0;
+        axbyczProb3(A1, B1, C1, A2, B2, C2, X_init, Y_init, Z_init,
+                    X_cal, Y_cal, Z_cal, num, params);
+
+        ASSERT_LT(num, 20);
+        ASSERT_LT((X_cal - X).norm(), 1e-5);
+        ASSERT_LT((Y_cal - Y).norm(), 1e-5);
+        ASSERT_LT((Z_cal - Z).norm(), 1e-5);
+    }
+}
+
+TEST_F(AxbyczProb3Test, NoisyDataStopsOnResidual) {
+    // Noisy B, the metric and b stay well above tol at the solution
+    for (int g = 0; g < 3; ++g) {
+        for (int k = 0; k < 20; ++k) {
+            B1[g][k] = B1[g][k] * randomPose(rng, 0.01);
+            B2[g][k] = B2[g][k] * randomPose(rng, 0.01);
+        }
+    }
+    Eigen::Matrix4d X_init = X * randomPose(rng, 0.1);
+    Eigen::Matrix4d Y_init = Y * randomPose(rng, 0.1);
+    Eigen::Matrix4d Z_init = Z * randomPose(rng, 0.1);
+
+    // Only the step norm ends the metric driven refinement
+    AxbyczProb3Params params;
+    Eigen::Matrix4d X_m, Y_m, Z_m;
+    double cost_m;
+    int num_m = 0;
+    axbyczProb3(A1, B1, C1, A2, B2, C2, X_init, Y_init, Z_init,
+                X_m, Y_m, Z_m, num_m, params, nullptr, nullptr, &cost_m);
+    ASSERT_GT(cost_m, params.tol);
+
+    // The residual ||M^T b|| vanishes at the solution one step earlier
+    params.metric_every = 0;
+    Eigen::Matrix4d X_cal, Y_cal, Z_cal;
+    double cost;
+    int num = 0;
+    axbyczProb3(A1, B1, C1, A2, B2, C2, X_init, Y_init, Z_init,
+                X_cal, Y_cal, Z_cal, num, params, nullptr, nullptr, &cost);
+
+    ASSERT_LT(num, num_m);
+    ASSERT_NEAR(cost, cost_m, 1e-6);
+    ASSERT_LT((X_cal - X_m).norm(), 1e-4);
+    ASSERT_LT((Y_cal - Y_m).norm(), 1e-4);
+    ASSERT_LT((Z_cal - Z_m).norm(), 1e-4);
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+#include "axbyczProbN.h"
+#include "syntheticData.h"
+
+class AxbyczProbNTest : public testing::Test {
+protected:
+    Eigen::Matrix4d X, Y, Z;
+    std::vector<Eigen::Matrix4d> A1, B1, C1, A2, B2, C2, A3, B3, C3;
+
+    // Noise-free data with A1, C2 and B3 fixed
+    AxbyczProbNTest() {
+        SyntheticDataParams params;
+        params.clusters = 1;
+        params.samples = 100;
+        params.spread = 0.5;
+        params.fixed_b = true;
+        SyntheticData d = syntheticData(7, params);
+        X = d.X;
+        Y = d.Y;
+        Z = d.Z;
+        A1 = d.A1[0];
+        B1 = d.B1[0];
+        C1 = d.C1[0];
+        A2 = d.A2[0];
+        B2 = d.B2[0];
+        C2 = d.C2[0];
+        A3 = d.A3[0];
+        B3 = d.B3[0];
+        C3 = d.C3[0];
+    }
+};
+
+TEST_F(AxbyczProbNTest, FixedAAndC) {
+    std::vector<FixtureGroup> groups = {
+            FixtureGroup(FixedPose::A, A1, B1, C1),
+            FixtureGroup(FixedPose::C, A2, B2, C2)};
+    std::vector<XYZCandidate> candidates;
+    ASSERT_EQ(axbyczProbN(groups, false, 0, 0, 1.5, 3, candidates), 3);
+
+    ASSERT_EQ(candidates.size(), 3u);
+    ASSERT_LE(candidates[0].cost, candidates[1].cost);
+    ASSERT_LE(candidates[1].cost, candidates[2].cost);
+    ASSERT_LT((candidates[0].X - X).norm(), 1e-6);
+    ASSERT_LT((candidates[0].Y - Y).norm(), 1e-6);
+    ASSERT_LT((candidates[0].Z - Z).norm(), 1e-6);
+}
+
+TEST_F(AxbyczProbNTest, FixedAAndCAndB) {
+    std::vector<FixtureGroup> groups = {
+            FixtureGroup(FixedPose::A, A1, B1, C1),
+            FixtureGroup(FixedPose::C, A2, B2, C2),
+            FixtureGroup(FixedPose::B, A3, B3, C3)};
+    std::vector<XYZCandidate> candidates;
+    axbyczProbN(groups, false, 0, 0, 1.8, 1, candidates);
+
+    ASSERT_EQ(candidates.size(), 1u);
+    ASSERT_LT(candidates[0].cost, 1e-6);
+    ASSERT_LT((candidates[0].X - X).norm(), 1e-6);
+    ASSERT_LT((candidates[0].Y - Y).norm(), 1e-6);
+    ASSERT_LT((candidates[0].Z - Z).norm(), 1e-6);
+}
+
+TEST_F(AxbyczProbNTest, RequiresFixedAAndC) {
+    std::vector<FixtureGroup> groups = {
+            FixtureGroup(FixedPose::C, A2, B2, C2),
+            FixtureGroup(FixedPose::B, A3, B3, C3)};
+    std::vector<XYZCandidate> candidates;
+    ASSERT_EQ(axbyczProbN(groups, false, 0, 0, 1.8, 1, candidates), 0);
+
+    ASSERT_TRUE(candidates.empty());
+}
+
+TEST_F(AxbyczProbNTest, NoCandidatesRequested) {
+    std::vector<FixtureGroup> groups = {
+            FixtureGroup(FixedPose::A, A1, B1, C1),
+            FixtureGroup(FixedPose::C, A2, B2, C2)};
+    std::vector<XYZCandidate> candidates;
+    ASSERT_EQ(axbyczProbN(groups, false, 0, 0, 1.5, 0, candidates), 0);
+
+    ASSERT_TRUE(candidates.empty());
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
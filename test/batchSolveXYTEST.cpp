@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+#include "batchSolveXY.h"
+
+class BatchSolveXYTest : public testing::Test {
+protected:
+    typedef Eigen::Matrix<double, 6, 1> Vector6d;
+
+    Eigen::Matrix4d X_true;
+    PoseStats statsA, statsB;
+
+    // Noise-free AX = XB data
+    BatchSolveXYTest() {
+        srand(9);
+        X_true = se3Exp(Vector6d::Random());
+        std::vector<Eigen::Matrix4d> A, B;
+        for (int i = 0; i < 100; ++i) {
+            A.push_back(se3Exp(0.5 * Vector6d::Random()));
+            B.push_back(X_true.inverse() * A.back() * X_true);
+        }
+        statsA = PoseStats(A);
+        statsB = PoseStats(B);
+    }
+};
+
+TEST_F(BatchSolveXYTest, SortEigenVectors) {
+    Eigen::Vector3d values(3, 1, 2);
+    Eigen::Matrix3d vectors = Eigen::Matrix3d::Identity();
+    sortEigenVectors(values, vectors);
+
+    ASSERT_TRUE(values == Eigen::Vector3d(1, 2, 3));
+    ASSERT_TRUE(vectors.col(0) == Eigen::Vector3d::UnitY());
+    ASSERT_TRUE(vectors.col(1) == Eigen::Vector3d::UnitZ());
+    ASSERT_TRUE(vectors.col(2) == Eigen::Vector3d::UnitX());
+}
+
+TEST_F(BatchSolveXYTest, ArrayMatchesVector) {
+    std::vector<Eigen::Matrix4d> X, Y;
+    batchSolveXY(statsA, statsB, false, 0, 0, X, Y);
+
+    std::array<Eigen::Matrix4d, 8> X_arr, Y_arr;
+    int n = batchSolveXY(statsA, statsB, false, 0, 0, X_arr, Y_arr);
+
+    ASSERT_EQ(n, 8);
+    ASSERT_EQ(X.size(), 8u);
+    for (int i = 0; i < n; ++i) {
+        ASSERT_TRUE(X_arr[i] == X[i]);
+        ASSERT_TRUE(Y_arr[i] == Y[i]);
+    }
+}
+
+TEST_F(BatchSolveXYTest, ProperOnly) {
+    std::vector<Eigen::Matrix4d> X, Y;
+    batchSolveXY(statsA, statsB, false, 0, 0, X, Y);
+
+    std::array<Eigen::Matrix4d, 8> X_arr, Y_arr;
+    int n = batchSolveXY(statsA, statsB, false, 0, 0, X_arr, Y_arr, true);
+
+    // The proper candidates, in the same order
+    ASSERT_EQ(n, 4);
+    int k = 0;
+    bool found = false;
+    for (size_t i = 0; i < X.size(); ++i) {
+        if (X[i].determinant() > 0) {
+            ASSERT_TRUE(X_arr[k].isApprox(X[i], 1e-12));
+            ASSERT_TRUE(Y_arr[k].isApprox(Y[i], 1e-12));
+            found = found || (X_arr[k] - X_true).norm() < 1e-6;
+            ++k;
+        }
+    }
+    ASSERT_EQ(k, n);
+    ASSERT_TRUE(found);
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
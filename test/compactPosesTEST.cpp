@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+#include "compactPoses.h"
+#include "loadMatrices.h"
+#include "meanCov.h"
+#include "metric.h"
+#include "axbyczProb1.h"
+#include "se3ExpLog.h"
+
+class CompactPosesTest : public testing::Test {
+protected:
+    typedef Eigen::Matrix<double, 6, 1> Vector6d;
+
+    std::vector<Eigen::Matrix4d> A, B, C;
+
+    CompactPosesTest() {
+        srand(5);
+        for (int i = 0; i < 50; ++i) {
+            A.push_back(se3Exp(2.0 * Vector6d::Random()));
+            B.push_back(se3Exp(0.3 * Vector6d::Random()));
+            C.push_back(se3Exp(0.3 * Vector6d::Random()));
+        }
+        // Rotation by pi, where the quaternion has w = 0
+        A[0].block<3, 3>(0, 0) = Eigen::Vector3d(-1, -1, 1).asDiagonal();
+    }
+};
+
+TEST_F(CompactPosesTest, RoundTrip) {
+    CompactPoses X(A);
+    ASSERT_EQ(X.size(), 50);
+    for (int i = 0; i < X.size(); ++i) {
+        ASSERT_TRUE(X[i].isApprox(A[i], 1e-14));
+        ASSERT_GE(X.rotation(i).w(), 0);
+        ASSERT_TRUE(X.translation(i).isApprox(A[i].block<3, 1>(0, 3)));
+    }
+
+    CompactPoses Y(2);
+    ASSERT_TRUE(Y[1].isIdentity());
+    Y.push_back(A[3]);
+    ASSERT_EQ(Y.size(), 3);
+    ASSERT_TRUE(Y[2].isApprox(A[3], 1e-14));
+    ASSERT_EQ(X.toMatrices().size(), A.size());
+}
+
+TEST_F(CompactPosesTest, StatisticsMatchVectors) {
+    CompactPoses cA(A), cB(B), cC(C);
+    std::vector<Eigen::Matrix4d> vB = cB.toMatrices();
+
+    Eigen::Matrix4d Mean, Mean_c;
+    Eigen::Matrix<double, 6, 6> Cov, Cov_c;
+    meanCov(vB, Mean, Cov);
+    meanCov(cB, Mean_c, Cov_c);
+    ASSERT_TRUE(Mean_c.isApprox(Mean, 1e-14));
+    ASSERT_TRUE(Cov_c.isApprox(Cov, 1e-14));
+
+    Eigen::Matrix4d X = se3Exp(Vector6d::Random());
+    Eigen::Matrix4d Y = se3Exp(Vector6d::Random());
+    Eigen::Matrix4d Z = se3Exp(Vector6d::Random());
+    ASSERT_NEAR(metric(cA, cB, cC, X, Y, Z), metric(A, B, C, X, Y, Z), 1e-12);
+    ASSERT_NEAR(metric(PoseArray(cA), PoseArray(cB), PoseArray(cC), X, Y, Z),
+                metric(A, B, C, X, Y, Z), 1e-12);
+}
+
+TEST_F(CompactPosesTest, SolversAndLoaderAcceptCompactPoses) {
+    // Prob1 on the compact data gives the same result as on its matrices
+    std::vector<Eigen::Matrix4d> A1(50, A[1]), A2(A.begin(), A.end()), C2(50, C[1]);
+    std::vector<Eigen::Matrix4d> B2(B.begin(), B.end());
+    CompactPoses cA1(A1), cB1(B), cC1(C), cA2(A2), cB2(B2), cC2(C2);
+
+    Eigen::Matrix4d X, Y, Z, X_c, Y_c, Z_c;
+    axbyczProb1(cA1.toMatrices(), cB1.toMatrices(), cC1.toMatrices(),
+                cA2.toMatrices(), cB2.toMatrices(), cC2.toMatrices(),
+                false, 0, 0, X, Y, Z);
+    axbyczProb1(cA1, cB1, cC1, cA2, cB2, cC2, false, 0, 0, X_c, Y_c, Z_c);
+    ASSERT_TRUE(X_c.isApprox(X, 1e-12));
+    ASSERT_TRUE(Y_c.isApprox(Y, 1e-12));
+    ASSERT_TRUE(Z_c.isApprox(Z, 1e-12));
+
+    // loadMatrices fills a CompactPoses
+    std::string path = "compactPosesTEST.txt";
+    std::ofstream file(path);
+    file.precision(17);
+    for (int i = 0; i < 3; ++i) {
+        file << A[i] << "\n";
+    }
+    file.close();
+
+    CompactPoses loaded;
+    loadMatrices(path, loaded);
+    std::remove(path.c_str());
+    ASSERT_GE(loaded.size(), 3);
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(loaded[i].isApprox(A[i], 1e-14));
+    }
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
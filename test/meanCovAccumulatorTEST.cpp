@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+#include "meanCov.h"
+#include "meanCovAccumulator.h"
+
+class MeanCovAccumulatorTest : public testing::Test {
+protected:
+    std::vector<Eigen::Matrix4d> X;
+
+    MeanCovAccumulatorTest() {
+        srand(7);
+        Eigen::Matrix<double, 6, 1> base = Eigen::Matrix<double, 6, 1>::Random();
+        for (int i = 0; i < 100; ++i) {
+            X.push_back(se3Exp(base) * se3Exp(0.2 * Eigen::Matrix<double, 6, 1>::Random()));
+        }
+    }
+};
+
+TEST_F(MeanCovAccumulatorTest, RefinedSnapshotMatchesMeanCov) {
+    MeanCovAccumulator acc(100);
+    for (const auto& x : X) {
+        acc.add(x);
+    }
+
+    Eigen::Matrix4d Mean, Mean_acc;
+    Eigen::Matrix<double, 6, 6> Cov, Cov_acc;
+    meanCov(X, Mean, Cov);
+    acc.snapshot(Mean_acc, Cov_acc);
+
+    ASSERT_EQ(acc.size(), 100);
+    ASSERT_TRUE(Mean_acc.isApprox(Mean, 1e-6));
+    ASSERT_TRUE(Cov_acc.isApprox(Cov, 1e-6));
+}
+
+TEST_F(MeanCovAccumulatorTest, IncrementalSnapshotIsClose) {
+    MeanCovAccumulator acc;
+    for (const auto& x : X) {
+        acc.add(x);
+    }
+
+    Eigen::Matrix4d Mean, Mean_acc;
+    Eigen::Matrix<double, 6, 6> Cov, Cov_acc;
+    meanCov(X, Mean, Cov);
+    acc.snapshot(Mean_acc, Cov_acc);
+
+    ASSERT_LT((Mean_acc - Mean).norm(), 1e-2);
+    ASSERT_LT((Cov_acc - Cov).norm(), 1e-2 * Cov.norm());
+}
+
+TEST_F(MeanCovAccumulatorTest, SlidingWindow) {
+    size_t window = 40;
+    MeanCovAccumulator acc(100);
+    for (size_t i = 0; i < X.size(); ++i) {
+        acc.add(X[i]);
+        if (i >= window) {
+            ASSERT_TRUE(acc.remove_oldest());
+        }
+    }
+    ASSERT_FALSE(acc.remove(X[0]));
+    ASSERT_EQ(acc.size(), window);
+
+    std::vector<Eigen::Matrix4d> last(X.end() - window, X.end());
+    Eigen::Matrix4d Mean, Mean_acc;
+    Eigen::Matrix<double, 6, 6> Cov, Cov_acc;
+    meanCov(last, Mean, Cov);
+    acc.snapshot(Mean_acc, Cov_acc);
+
+    ASSERT_TRUE(Mean_acc.isApprox(Mean, 1e-6));
+    ASSERT_TRUE(Cov_acc.isApprox(Cov, 1e-6));
+}
+
+TEST_F(MeanCovAccumulatorTest, RemoveAnySample) {
+    MeanCovAccumulator acc(100);
+    for (const auto& x : X) {
+        acc.add(x);
+    }
+    std::vector<Eigen::Matrix4d> rest;
+    for (size_t i = 0; i < X.size(); ++i) {
+        if (i % 3 == 1) {
+            ASSERT_TRUE(acc.remove(X[i]));
+        } else {
+            rest.push_back(X[i]);
+        }
+    }
+    ASSERT_EQ(acc.size(), static_cast<int>(rest.size()));
+
+    Eigen::Matrix4d Mean, Mean_acc;
+    Eigen::Matrix<double, 6, 6> Cov, Cov_acc;
+    meanCov(rest, Mean, Cov);
+    acc.snapshot(Mean_acc, Cov_acc);
+
+    ASSERT_TRUE(Mean_acc.isApprox(Mean, 1e-6));
+    ASSERT_TRUE(Cov_acc.isApprox(Cov, 1e-6));
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
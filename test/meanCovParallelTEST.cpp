@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+#include "meanCov.h"
+
+class MeanCovParallelTest : public testing::Test {
+protected:
+    std::vector<Eigen::Matrix4d> X;
+
+    MeanCovParallelTest() {
+        srand(11);
+        Eigen::Matrix<double, 6, 1> base = Eigen::Matrix<double, 6, 1>::Random();
+        for (int i = 0; i < 1000; ++i) {
+            X.push_back(se3Exp(base) * se3Exp(0.2 * Eigen::Matrix<double, 6, 1>::Random()));
+        }
+    }
+};
+
+TEST_F(MeanCovParallelTest, MatchesMeanCov) {
+    ThreadPool pool(4);
+    Eigen::Matrix4d Mean, Mean_par;
+    Eigen::Matrix<double, 6, 6> Cov, Cov_par;
+    meanCov(X, Mean, Cov);
+    meanCovParallel(X, Mean_par, Cov_par, pool, 64);
+
+    ASSERT_TRUE(Mean_par.isApprox(Mean, 1e-10));
+    ASSERT_TRUE(Cov_par.isApprox(Cov, 1e-10));
+}
+
+TEST_F(MeanCovParallelTest, BitReproducibleForFixedThreadCount) {
+    ThreadPool pool(3);
+    Eigen::Matrix4d Mean1, Mean2;
+    Eigen::Matrix<double, 6, 6> Cov1, Cov2;
+    meanCovParallel(X, Mean1, Cov1, pool, 64);
+    for (int k = 0; k < 5; ++k) {
+        meanCovParallel(X, Mean2, Cov2, pool, 64);
+        ASSERT_TRUE(Mean1 == Mean2);
+        ASSERT_TRUE(Cov1 == Cov2);
+    }
+}
+
+TEST_F(MeanCovParallelTest, SmallInputStaysSerial) {
+    ThreadPool pool(4);
+    std::vector<Eigen::Matrix4d> small(X.begin(), X.begin() + 100);
+    Eigen::Matrix4d Mean, Mean_par;
+    Eigen::Matrix<double, 6, 6> Cov, Cov_par;
+    meanCov(small, Mean, Cov);
+    meanCovParallel(small, Mean_par, Cov_par, pool);
+
+    ASSERT_TRUE(Mean_par == Mean);
+    ASSERT_TRUE(Cov_par == Cov);
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+#include "monteCarloSweep.h"
+
+// A cell that draws from its streams and records which cell ran
+Eigen::MatrixXd runSweep(int num_threads, Eigen::MatrixXi &runs, std::vector<SweepProgress> &reports) {
+    int num_trials = 7, num_rates = 5;
+    Eigen::MatrixXd result = Eigen::MatrixXd::Zero(num_rates, num_trials);
+    runs = Eigen::MatrixXi::Zero(num_rates, num_trials);
+
+    ThreadPool pool(num_threads);
+    monteCarloSweep(pool, 42, num_trials, num_rates, [&](const SweepCell &cell) {
+        RngStream shared = cell.trialStream(RngPurpose::GroundTruth);
+        RngStream own = cell.stream(RngPurpose::Data);
+        double sum = shared.uniform();
+        for (int i = 0; i < 1000; ++i) {
+            sum += own.normal();
+        }
+        result(cell.rate, cell.trial) = sum;
+        runs(cell.rate, cell.trial) += 1;
+    }, [&](const SweepProgress &p) { reports.push_back(p); }, 1e-3);
+    return result;
+}
+
+TEST(MonteCarloSweepTest, RunsEveryCellOnce) {
+    Eigen::MatrixXi runs;
+    std::vector<SweepProgress> reports;
+    runSweep(3, runs, reports);
+
+    ASSERT_TRUE((runs.array() == 1).all());
+    ASSERT_FALSE(reports.empty());
+    ASSERT_EQ(reports.back().done, 35);
+    ASSERT_EQ(reports.back().total, 35);
+    for (size_t k = 1; k < reports.size(); ++k) {
+        ASSERT_GE(reports[k].done, reports[k - 1].done);
+    }
+}
+
+TEST(MonteCarloSweepTest, ResultsDoNotDependOnThreads) {
+    Eigen::MatrixXi runs;
+    std::vector<SweepProgress> reports;
+    Eigen::MatrixXd serial = runSweep(1, runs, reports);
+    Eigen::MatrixXd parallel = runSweep(4, runs, reports);
+    ASSERT_TRUE(serial == parallel);
+
+    // Cells draw from distinct streams
+    for (int rk = 1; rk < serial.rows(); ++rk) {
+        ASSERT_NE(serial(rk, 0), serial(0, 0));
+    }
+}
+
+TEST(MonteCarloSweepTest, TrialStreamIsSharedByRates) {
+    SweepCell a = {3, 2, 0}, b = {3, 2, 4}, c = {3, 5, 0};
+    RngStream sa = a.trialStream(RngPurpose::GroundTruth);
+    RngStream sb = b.trialStream(RngPurpose::GroundTruth);
+    RngStream sc = c.trialStream(RngPurpose::GroundTruth);
+    uint32_t x = sa();
+    ASSERT_EQ(x, sb());
+    ASSERT_NE(x, sc());
+
+    RngStream oa = a.stream(RngPurpose::GroundTruth);
+    RngStream ob = b.stream(RngPurpose::GroundTruth);
+    ASSERT_NE(oa(), ob());
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
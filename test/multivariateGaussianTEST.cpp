@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include <eigen3/Eigen/Dense>
+#include "mvg.h"
+
+class MultivariateGaussianTest : public testing::Test {
+protected:
+    Eigen::VectorXd mu;
+    Eigen::MatrixXd Sigma;
+
+    MultivariateGaussianTest() : mu(3), Sigma(3, 3) {
+        mu << 1.0, 2.0, 3.0;
+        Sigma << 1.0, 0.5, 0.5, 0.5, 1.0, 0.5, 0.5, 0.5, 1.0;
+    }
+};
+
+TEST_F(MultivariateGaussianTest, SampleMomentsMatch) {
+    MultivariateGaussian gaussian(mu, Sigma, 7);
+    ASSERT_TRUE((gaussian.factor() * gaussian.factor().transpose()).isApprox(Sigma, 1e-12));
+
+    int N = 200000;
+    Eigen::MatrixXd y;
+    gaussian.sample(N, y);
+    ASSERT_EQ(y.rows(), 3);
+    ASSERT_EQ(y.cols(), N);
+
+    Eigen::VectorXd mean = y.rowwise().mean();
+    Eigen::MatrixXd centered = y.colwise() - mean;
+    Eigen::MatrixXd cov = centered * centered.transpose() / (N - 1);
+    ASSERT_LT((mean - mu).cwiseAbs().maxCoeff(), 1e-2);
+    ASSERT_LT((cov - Sigma).cwiseAbs().maxCoeff(), 2e-2);
+}
+
+TEST_F(MultivariateGaussianTest, SeededDrawsRepeat) {
+    MultivariateGaussian g1(mu, Sigma, 42), g2(mu, Sigma, 42);
+    Eigen::MatrixXd y1 = g1.sample(10);
+    Eigen::MatrixXd y2(3, 4);
+    g2.sample(4, y2);
+    ASSERT_TRUE(y1.leftCols(4).isApprox(y2));
+
+    // The engine carries on between calls
+    g2.sample(6, y2);
+    ASSERT_TRUE(y1.rightCols(6).isApprox(y2));
+
+    g1.seed(42);
+    ASSERT_TRUE(g1.sample(10).isApprox(y1));
+}
+
+TEST_F(MultivariateGaussianTest, RejectsInvalidSigma) {
+    Eigen::MatrixXd notSPD(3, 3);
+    notSPD << 1.0, 0.5, 0.5, 0.5, 1.0, -0.5, 0.5, -0.5, 1.0;
+    ASSERT_DEATH(MultivariateGaussian(mu, notSPD), ".*Sigma must be positive definite\\..*");
+
+    MultivariateGaussian gaussian(mu, Sigma);
+    Eigen::MatrixXd y;
+    ASSERT_DEATH(gaussian.sample(0, y), ".*A positive integer number of samples must be requested\\..*");
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+#include "permutedPoses.h"
+#include "scrambleData.h"
+#include "batchSolveXY.h"
+#include "axbyczProb1.h"
+#include "axbyczProb3.h"
+#include "syntheticData.h"
+
+class PermutedPosesTest : public testing::Test {
+protected:
+    Eigen::Matrix4d X, Y, Z;
+    std::vector<Eigen::Matrix4d> A1, B1, C1, A2, B2, C2;
+
+    // Noise-free data with A1 and C2 fixed
+    PermutedPosesTest() {
+        SyntheticDataParams params;
+        params.clusters = 1;
+        params.samples = 50;
+        params.spread = 0.5;
+        SyntheticData d = syntheticData(5, params);
+        X = d.X;
+        Y = d.Y;
+        Z = d.Z;
+        A1 = d.A1[0];
+        B1 = d.B1[0];
+        C1 = d.C1[0];
+        A2 = d.A2[0];
+        B2 = d.B2[0];
+        C2 = d.C2[0];
+    }
+};
+
+TEST_F(PermutedPosesTest, ViewMatchesScrambledCopy) {
+    RngStream rng1(9, 2, rngStreamId(RngPurpose::Scramble, 3));
+    RngStream rng2(9, 2, rngStreamId(RngPurpose::Scramble, 3));
+    std::vector<Eigen::Matrix4d> Bp = scrambleData(B1, 40, rng1);
+    PermutedPoses<> Bv = scrambleView(B1, 40, rng2);
+
+    ASSERT_EQ(Bv.size(), static_cast<int>(B1.size()));
+    for (int i = 0; i < Bv.size(); ++i) {
+        ASSERT_TRUE(Bv[i] == Bp[i]);
+        // The view refers to the stored poses
+        ASSERT_EQ(&Bv[i], &B1[Bv.indices()[i]]);
+    }
+
+    PermutedPoses<> Identity(B1);
+    for (int i = 0; i < Identity.size(); ++i) {
+        ASSERT_EQ(&Identity[i], &B1[i]);
+    }
+}
+
+TEST_F(PermutedPosesTest, StatisticsMatchCopies) {
+    RngStream rng(9, 0, rngStreamId(RngPurpose::Scramble, 5));
+    PermutedPoses<> Bv = scrambleView(B1, 50, rng);
+    PermutedPoses<> C1v(C1);
+    std::vector<Eigen::Matrix4d> Bp = Bv.toMatrices();
+
+    Eigen::Matrix4d Mean, Mean_v;
+    Eigen::Matrix<double, 6, 6> Cov, Cov_v;
+    meanCov(Bp, Mean, Cov);
+    meanCov(Bv, Mean_v, Cov_v);
+    ASSERT_TRUE(Mean_v == Mean);
+    ASSERT_TRUE(Cov_v == Cov);
+
+    PermutedPoses<> A1v(A1);
+    ASSERT_EQ(metric(A1v, Bv, C1v, X, Y, Z), metric(A1, Bp, C1, X, Y, Z));
+
+    std::vector<Eigen::Matrix4d> X_c, Y_c, X_cv, Y_cv;
+    Eigen::Matrix4d MA, MB;
+    Eigen::Matrix<double, 6, 6> SA, SB;
+    batchSolveXY(C1, Bp, false, 0, 0, X_c, Y_c, MA, MB, SA, SB);
+    batchSolveXY(C1v, Bv, false, 0, 0, X_cv, Y_cv, MA, MB, SA, SB);
+    ASSERT_EQ(X_c.size(), X_cv.size());
+    for (size_t k = 0; k < X_c.size(); ++k) {
+        ASSERT_TRUE(X_cv[k] == X_c[k]);
+        ASSERT_TRUE(Y_cv[k] == Y_c[k]);
+    }
+}
+
+TEST_F(PermutedPosesTest, SolversMatchCopies) {
+    RngStream rng1(9, 0, rngStreamId(RngPurpose::Scramble, 1, 0));
+    RngStream rng2(9, 0, rngStreamId(RngPurpose::Scramble, 1, 1));
+    PermutedPoses<> A1v(A1), C1v(C1), A2v(A2), C2v(C2);
+    PermutedPoses<> B1v = scrambleView(B1, 20, rng1);
+    PermutedPoses<> B2v = scrambleView(B2, 20, rng2);
+    std::vector<Eigen::Matrix4d> B1p = B1v.toMatrices(), B2p = B2v.toMatrices();
+
+    Eigen::Matrix4d X1, Y1, Z1, X1v, Y1v, Z1v;
+    axbyczProb1(A1, B1p, C1, A2, B2p, C2, false, 0, 0, X1, Y1, Z1);
+    axbyczProb1(A1v, B1v, C1v, A2v, B2v, C2v, false, 0, 0, X1v, Y1v, Z1v);
+    ASSERT_TRUE(X1v == X1);
+    ASSERT_TRUE(Y1v == Y1);
+    ASSERT_TRUE(Z1v == Z1);
+
+    Eigen::Matrix4d X3, Y3, Z3, X3v, Y3v, Z3v;
+    int num = 0, num_v = 0;
+    AxbyczProb3Params params;
+    params.max_num = 5;
+    axbyczProb3(A1, B1p, C1, A2, B2p, C2, X1, Y1, Z1, X3, Y3, Z3, num, params);
+    axbyczProb3(A1v, B1v, C1v, A2v, B2v, C2v, X1, Y1, Z1, X3v, Y3v, Z3v, num_v, params);
+    ASSERT_EQ(num_v, num);
+    ASSERT_TRUE(X3v == X3);
+    ASSERT_TRUE(Y3v == Y3);
+    ASSERT_TRUE(Z3v == Z3);
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
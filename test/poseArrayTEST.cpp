@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+#include "poseArray.h"
+#include "metric.h"
+#include "rotError.h"
+#include "tranError.h"
+#include "se3ExpLog.h"
+
+class PoseArrayTest : public testing::Test {
+protected:
+    typedef Eigen::Matrix<double, 6, 1> Vector6d;
+
+    Eigen::Matrix4d X, Y, Z;
+    std::vector<Eigen::Matrix4d> A, B, C;
+
+    // 70 samples, not a multiple of the chunk size
+    PoseArrayTest() {
+        srand(13);
+        X = se3Exp(Vector6d::Random());
+        Y = se3Exp(Vector6d::Random());
+        Z = se3Exp(Vector6d::Random());
+        for (int i = 0; i < 70; ++i) {
+            A.push_back(se3Exp(2.0 * Vector6d::Random()));
+            B.push_back(se3Exp(2.0 * Vector6d::Random()));
+            C.push_back(se3Exp(2.0 * Vector6d::Random()));
+        }
+        // Rotation errors of exactly 0 and pi
+        B[0] = A[0];
+        B[1] = A[1];
+        B[1].block<3, 3>(0, 0) = A[1].block<3, 3>(0, 0) * Eigen::Vector3d(-1, -1, 1).asDiagonal();
+    }
+};
+
+TEST_F(PoseArrayTest, MetricMatchesVectors) {
+    PoseArray pA(A), pB(B), pC(C);
+    Eigen::VectorXd res;
+    metric(pA, pB, pC, X, Y, Z, res);
+
+    ASSERT_EQ(res.size(), 70);
+    for (int i = 0; i < 70; ++i) {
+        double expected = (A[i] * X * B[i] - Y * C[i] * Z).norm();
+        ASSERT_NEAR(res[i], expected, 1e-12 * expected);
+    }
+    ASSERT_NEAR(metric(pA, pB, pC, X, Y, Z), metric(A, B, C, X, Y, Z), 1e-12);
+}
+
+TEST_F(PoseArrayTest, RotErrorMatchesPairs) {
+    PoseArray pA(A), pB(B);
+    Eigen::VectorXd err;
+    rotError(pA, pB, err);
+
+    ASSERT_EQ(err.size(), 70);
+    ASSERT_EQ(err[0], 0);
+    ASSERT_NEAR(err[1], M_PI, 1e-12);
+    for (int i = 2; i < 70; ++i) {
+        ASSERT_NEAR(err[i], rotError(A[i], B[i]), 1e-9);
+    }
+    ASSERT_NEAR(rotError(pA, pB), err.mean(), 1e-15);
+}
+
+TEST_F(PoseArrayTest, TranErrorMatchesPairs) {
+    PoseArray pA(A), pB(B);
+    Eigen::VectorXd err;
+    tranError(pA, pB, err);
+
+    ASSERT_EQ(err.size(), 70);
+    for (int i = 0; i < 70; ++i) {
+        ASSERT_NEAR(err[i], tranError(A[i], B[i]), 1e-12);
+    }
+    ASSERT_NEAR(tranError(pA, pB), err.mean(), 1e-15);
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+#include "poseBatch.h"
+#include "meanCov.h"
+#include "batchSolveXY.h"
+
+class PoseBatchTest : public testing::Test {
+protected:
+    typedef Eigen::Matrix<double, 6, 1> Vector6d;
+
+    std::vector<std::vector<Eigen::Matrix4d>> A, B;
+
+    // Datasets of different sizes, one with a sample rotated by almost pi
+    // relative to the others
+    PoseBatchTest() : A(5), B(5) {
+        srand(11);
+        for (int k = 0; k < 5; ++k) {
+            Eigen::Matrix4d X = se3Exp(Vector6d::Random());
+            Eigen::Matrix4d base = se3Exp(2.0 * Vector6d::Random());
+            for (int i = 0; i < 40 + 10 * k; ++i) {
+                A[k].push_back(base * se3Exp(0.4 * Vector6d::Random()));
+                B[k].push_back(X.inverse() * A[k].back() * X);
+            }
+        }
+        Vector6d flip = Vector6d::Zero();
+        flip(0) = 3.1;
+        A[2][3] = A[2][3] * se3Exp(flip);
+    }
+};
+
+TEST_F(PoseBatchTest, StoresPoses) {
+    PoseBatch batch(A);
+
+    ASSERT_EQ(batch.datasets(), 5);
+    ASSERT_EQ(batch.capacity(), 80);
+    ASSERT_EQ(batch.size(1), 50);
+    ASSERT_TRUE(batch.pose(1, 7) == A[1][7]);
+    ASSERT_TRUE(batch.pose(0, 60) == Eigen::Matrix4d::Identity());
+}
+
+TEST_F(PoseBatchTest, MatchesMeanCov) {
+    std::vector<Eigen::Matrix4d> Mean;
+    std::vector<Eigen::Matrix<double, 6, 6>> Cov;
+    meanCov(PoseBatch(A), Mean, Cov);
+
+    ASSERT_EQ(Mean.size(), 5u);
+    for (int k = 0; k < 5; ++k) {
+        Eigen::Matrix4d Mean_k;
+        Eigen::Matrix<double, 6, 6> Cov_k;
+        meanCov(A[k], Mean_k, Cov_k);
+        ASSERT_TRUE(Mean[k].isApprox(Mean_k, 1e-12));
+        ASSERT_TRUE(Cov[k].isApprox(Cov_k, 1e-12));
+    }
+}
+
+TEST_F(PoseBatchTest, BatchSolveXYMatchesSingleDataset) {
+    std::vector<std::array<Eigen::Matrix4d, 8>> X, Y;
+    std::vector<Eigen::Matrix4d> MeanA, MeanB;
+    std::vector<Eigen::Matrix<double, 6, 6>> SigA, SigB;
+    int n = batchSolveXY(PoseBatch(A), PoseBatch(B), false, 0, 0,
+                         X, Y, MeanA, MeanB, SigA, SigB, true);
+
+    ASSERT_EQ(n, 4);
+    ASSERT_EQ(X.size(), 5u);
+    for (int k = 0; k < 5; ++k) {
+        std::array<Eigen::Matrix4d, 8> X_k, Y_k;
+        batchSolveXY(PoseStats(A[k]), PoseStats(B[k]), false, 0, 0, X_k, Y_k, true);
+        for (int i = 0; i < n; ++i) {
+            ASSERT_TRUE(X[k][i].isApprox(X_k[i], 1e-8));
+            ASSERT_TRUE(Y[k][i].isApprox(Y_k[i], 1e-8));
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
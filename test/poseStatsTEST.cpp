@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+#include "poseStats.h"
+#include "batchSolveXY.h"
+
+class PoseStatsTest : public testing::Test {
+protected:
+    std::vector<Eigen::Matrix4d> A, B, A_inv, B_inv;
+
+    PoseStatsTest() {
+        srand(5);
+        Eigen::Matrix<double, 6, 1> base = Eigen::Matrix<double, 6, 1>::Random();
+        for (int i = 0; i < 200; ++i) {
+            A.push_back(se3Exp(base) * se3Exp(0.3 * Eigen::Matrix<double, 6, 1>::Random()));
+            B.push_back(se3Exp(0.3 * Eigen::Matrix<double, 6, 1>::Random()) * se3Exp(base));
+            A_inv.push_back(A.back().inverse());
+            B_inv.push_back(B.back().inverse());
+        }
+    }
+};
+
+TEST_F(PoseStatsTest, MatchesMeanCov) {
+    PoseStats stats(A);
+    Eigen::Matrix4d Mean;
+    Eigen::Matrix<double, 6, 6> Cov;
+    meanCov(A, Mean, Cov);
+
+    ASSERT_TRUE(stats.mean() == Mean);
+    ASSERT_TRUE(stats.cov() == Cov);
+}
+
+TEST_F(PoseStatsTest, InverseMatchesMeanCovOfInverses) {
+    PoseStats stats(A);
+    Eigen::Matrix4d Mean_inv;
+    Eigen::Matrix<double, 6, 6> Cov_inv;
+    meanCov(A_inv, Mean_inv, Cov_inv);
+
+    ASSERT_TRUE(stats.meanInv().isApprox(Mean_inv, 1e-5));
+    ASSERT_TRUE(stats.covInv().isApprox(Cov_inv, 1e-4));
+
+    PoseStats inv = stats.inverse();
+    ASSERT_TRUE(inv.mean() == stats.meanInv());
+    ASSERT_TRUE(inv.meanInv().isApprox(stats.mean(), 1e-12));
+    ASSERT_TRUE(inv.covInv().isApprox(stats.cov(), 1e-12));
+}
+
+TEST_F(PoseStatsTest, BatchSolveXYMatchesRawData) {
+    std::vector<Eigen::Matrix4d> X, Y, X_stats, Y_stats;
+    Eigen::Matrix4d MeanA, MeanB;
+    Eigen::Matrix<double, 6, 6> SigA, SigB;
+    batchSolveXY(A, B_inv, true, 1e-4, 1e-4, X, Y, MeanA, MeanB, SigA, SigB);
+
+    PoseStats statsA(A), statsB(B);
+    batchSolveXY(statsA, statsB.inverse(), true, 1e-4, 1e-4, X_stats, Y_stats);
+
+    ASSERT_EQ(X_stats.size(), X.size());
+    for (size_t i = 0; i < X.size(); ++i) {
+        ASSERT_TRUE(X_stats[i].isApprox(X[i], 1e-3));
+        ASSERT_TRUE(Y_stats[i].isApprox(Y[i], 1e-3));
+    }
+
+    // opt must not change the cached statistics
+    ASSERT_TRUE(statsA.cov() == PoseStats(A).cov());
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
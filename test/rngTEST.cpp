@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+#include "rng.h"
+#include "generateABC.h"
+#include "scrambleData.h"
+
+// Known answers of Philox4x32-10 from the Random123 distribution
+TEST(RngTest, PhiloxKnownAnswers) {
+    std::array<uint32_t, 4> zero = philox4x32({0, 0, 0, 0}, {0, 0});
+    std::array<uint32_t, 4> zero_expected = {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8};
+    ASSERT_EQ(zero, zero_expected);
+
+    std::array<uint32_t, 4> pi = philox4x32({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+                                            {0xa4093822, 0x299f31d0});
+    std::array<uint32_t, 4> pi_expected = {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1};
+    ASSERT_EQ(pi, pi_expected);
+}
+
+TEST(RngTest, StreamsAreReproducibleAndDistinct) {
+    RngStream a(7, 3, rngStreamId(RngPurpose::Scramble, 2, 1));
+    RngStream b(7, 3, rngStreamId(RngPurpose::Scramble, 2, 1));
+    RngStream other_trial(7, 4, rngStreamId(RngPurpose::Scramble, 2, 1));
+    RngStream other_stream(7, 3, rngStreamId(RngPurpose::Scramble, 2, 0));
+
+    int same_trial = 0, same_stream = 0;
+    for (int i = 0; i < 1000; ++i) {
+        uint32_t x = a();
+        ASSERT_EQ(x, b());
+        same_trial += x == other_trial();
+        same_stream += x == other_stream();
+    }
+    ASSERT_LT(same_trial, 3);
+    ASSERT_LT(same_stream, 3);
+
+    // Moments of the uniform and normal draws
+    int N = 200000;
+    double sum_u = 0, sum_n = 0, sum_n2 = 0;
+    int max_int = 0;
+    for (int i = 0; i < N; ++i) {
+        double u = a.uniform();
+        ASSERT_GE(u, 0.0);
+        ASSERT_LT(u, 1.0);
+        sum_u += u;
+        double n = a.normal();
+        sum_n += n;
+        sum_n2 += n * n;
+        max_int = std::max(max_int, a.uniformInt(10));
+    }
+    ASSERT_NEAR(sum_u / N, 0.5, 5e-3);
+    ASSERT_NEAR(sum_n / N, 0.0, 1e-2);
+    ASSERT_NEAR(sum_n2 / N, 1.0, 1e-2);
+    ASSERT_EQ(max_int, 9);
+}
+
+TEST(RngTest, DataGenerationIsReproducible) {
+    Eigen::Matrix4d X = Eigen::Matrix4d::Identity(), Y = X, Z = X;
+    Eigen::VectorXd M = Eigen::VectorXd::Zero(6);
+    Eigen::MatrixXd Sig = 0.1 * Eigen::MatrixXd::Identity(6, 6);
+
+    std::vector<Eigen::Matrix4d> A1, B1, C1, A2, B2, C2;
+    RngStream rng1(11, 5, rngStreamId(RngPurpose::Data, 0));
+    RngStream rng2(11, 5, rngStreamId(RngPurpose::Data, 0));
+    std::tie(A1, B1, C1) = generateABC(20, 3, 1, M, Sig, X, Y, Z, rng1);
+    std::tie(A2, B2, C2) = generateABC(20, 3, 1, M, Sig, X, Y, Z, rng2);
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_TRUE(A1[i] == A2[i]);
+        ASSERT_TRUE(B1[i] == B2[i]);
+        ASSERT_TRUE(C1[i] == C2[i]);
+    }
+
+    RngStream s1(11, 5, rngStreamId(RngPurpose::Scramble, 4));
+    RngStream s2(11, 5, rngStreamId(RngPurpose::Scramble, 4));
+    std::vector<Eigen::Matrix4d> Bp1 = scrambleData(B1, 50, s1);
+    std::vector<Eigen::Matrix4d> Bp2 = scrambleData(B1, 50, s2);
+    int moved = 0;
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_TRUE(Bp1[i] == Bp2[i]);
+        moved += !(Bp1[i] == B1[i]);
+    }
+    ASSERT_GT(moved, 0);
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
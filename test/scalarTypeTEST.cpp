@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+#include "axbyczProb1.h"
+#include "axbyczProb3.h"
+#include "getErrorAXBYCZ.h"
+#include "meanCov.h"
+#include "metric.h"
+#include "se3ExpLog.h"
+#include "syntheticData.h"
+
+class ScalarTypeTest : public testing::Test, protected SyntheticData {
+protected:
+    // Draws of the initial guesses
+    RngStream rng;
+
+    // Three fixed-A and three fixed-C clusters with a little noise on B
+    ScalarTypeTest() : SyntheticData(syntheticData(21, dataParams())), rng(21, 1) {}
+
+    static SyntheticDataParams dataParams() {
+        SyntheticDataParams p;
+        p.samples = 100;
+        p.spread = 0.5;
+        p.noise = 1e-4;
+        return p;
+    }
+};
+
+TEST_F(ScalarTypeTest, StatisticsAndMetricInFloat) {
+    Eigen::Matrix4d Mean;
+    Eigen::Matrix<double, 6, 6> Cov;
+    Eigen::Matrix4f Mean_f;
+    Eigen::Matrix<float, 6, 6> Cov_f;
+    meanCov(C1[0], Mean, Cov);
+    meanCov(C1[0], Mean_f, Cov_f);
+    ASSERT_LT((Mean_f.cast<double>() - Mean).norm(), 1e-5);
+    ASSERT_LT((Cov_f.cast<double>() - Cov).norm(), 1e-5 * Cov.norm());
+
+    Eigen::Matrix4f X_f = X.cast<float>(), Y_f = Y.cast<float>(), Z_f = Z.cast<float>();
+    double m = metric(A1[0], B1[0], C1[0], X, Y, Z);
+    ASSERT_NEAR(metric(A1[0], B1[0], C1[0], X_f, Y_f, Z_f), m, 1e-5);
+    ASSERT_NEAR(metric(PoseArrayf(A1[0]), PoseArrayf(B1[0]), PoseArrayf(C1[0]), X_f, Y_f, Z_f), m, 1e-5);
+
+    Eigen::VectorXf err = getErrorAXBYCZ(X_f, Y_f, Z_f, X_f, Y_f, Z_f);
+    ASSERT_EQ(err.size(), 6);
+    ASSERT_LT(err.norm(), 1e-3);
+}
+
+TEST_F(ScalarTypeTest, Prob1InFloatMatchesDouble) {
+    Eigen::Matrix4d X1, Y1, Z1;
+    Eigen::Matrix4f X1_f, Y1_f, Z1_f;
+    axbyczProb1(A1[0], B1[0], C1[0], A2[0], B2[0], C2[0], false, 0, 0, X1, Y1, Z1);
+    axbyczProb1(A1[0], B1[0], C1[0], A2[0], B2[0], C2[0], false, 0, 0, X1_f, Y1_f, Z1_f);
+
+    Eigen::VectorXd diff = getErrorAXBYCZ(Eigen::Matrix4d(X1_f.cast<double>()),
+                                          Eigen::Matrix4d(Y1_f.cast<double>()),
+                                          Eigen::Matrix4d(Z1_f.cast<double>()), X1, Y1, Z1);
+    ASSERT_LT(diff.maxCoeff(), 1e-3);
+}
+
+TEST_F(ScalarTypeTest, Prob3InFloatMatchesDouble) {
+    Eigen::Matrix4d X_init = X * randomPose(rng, 0.05);
+    Eigen::Matrix4d Y_init = Y * randomPose(rng, 0.05);
+    Eigen::Matrix4d Z_init = Z * randomPose(rng, 0.05);
+
+    Eigen::Matrix4d X3, Y3, Z3;
+    Eigen::Matrix4f X3_f, Y3_f, Z3_f;
+    int num = 0, num_f = 0;
+    AxbyczProb3Params params;
+    params.max_num = 20;
+    axbyczProb3(A1, B1, C1, A2, B2, C2, X_init, Y_init, Z_init, X3, Y3, Z3, num, params);
+    axbyczProb3(A1, B1, C1, A2, B2, C2,
+                Eigen::Matrix4f(X_init.cast<float>()), Eigen::Matrix4f(Y_init.cast<float>()),
+                Eigen::Matrix4f(Z_init.cast<float>()), X3_f, Y3_f, Z3_f, num_f, params);
+
+    Eigen::VectorXd err = getErrorAXBYCZ(X3, Y3, Z3, X, Y, Z);
+    Eigen::VectorXd err_f = getErrorAXBYCZ(Eigen::Matrix4d(X3_f.cast<double>()),
+                                           Eigen::Matrix4d(Y3_f.cast<double>()),
+                                           Eigen::Matrix4d(Z3_f.cast<double>()), X, Y, Z);
+    ASSERT_LT(err.maxCoeff(), 1e-2);
+    ASSERT_LT(err_f.maxCoeff(), 1e-2);
+    ASSERT_LT((err_f - err).cwiseAbs().maxCoeff(), 1e-3);
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
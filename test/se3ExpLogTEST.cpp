@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include <eigen3/Eigen/Dense>
+#include <unsupported/Eigen/MatrixFunctions>
+#include "se3ExpLog.h"
+#include "se3Vec.h"
+
+TEST(Se3ExpLogTest, ExpMatchesMatrixExponential) {
+    srand(1);
+    for (int k = 0; k < 50; ++k) {
+        Eigen::Matrix<double, 6, 1> xi = Eigen::Matrix<double, 6, 1>::Random();
+        Eigen::Matrix4d expected = Eigen::Matrix4d(se3Vec(xi)).exp();
+        ASSERT_TRUE(se3Exp(xi).isApprox(expected, 1e-12));
+    }
+}
+
+TEST(Se3ExpLogTest, LogMatchesMatrixLogarithm) {
+    srand(2);
+    for (int k = 0; k < 50; ++k) {
+        Eigen::Matrix<double, 6, 1> xi = Eigen::Matrix<double, 6, 1>::Random();
+        Eigen::Matrix4d X = se3Exp(xi);
+        Eigen::Matrix<double, 6, 1> expected = se3Vec(Eigen::Matrix4d(X.log()));
+        ASSERT_TRUE(se3Log(X).isApprox(expected, 1e-10));
+    }
+}
+
+TEST(Se3ExpLogTest, RoundTripSmallAngle) {
+    Eigen::Matrix<double, 6, 1> xi;
+    xi << 1e-7, -2e-7, 3e-7, 0.1, 0.2, 0.3;
+    ASSERT_TRUE(se3Log(se3Exp(xi)).isApprox(xi, 1e-12));
+
+    Eigen::Matrix<double, 6, 1> zero = Eigen::Matrix<double, 6, 1>::Zero();
+    ASSERT_TRUE(se3Exp(zero).isApprox(Eigen::Matrix4d::Identity()));
+    ASSERT_TRUE(se3Log(Eigen::Matrix4d::Identity()).isZero());
+}
+
+TEST(Se3ExpLogTest, RoundTripNearPi) {
+    Eigen::Vector3d axis = Eigen::Vector3d(1, -2, 0.5).normalized();
+    for (double theta : {M_PI - 1e-3, M_PI - 1e-8, M_PI}) {
+        Eigen::Matrix<double, 6, 1> xi;
+        xi << theta * axis, 0.4, -0.1, 0.7;
+        Eigen::Matrix4d X = se3Exp(xi);
+        Eigen::Matrix4d X_back = se3Exp(se3Log(X));
+        ASSERT_TRUE(X_back.isApprox(X, 1e-9));
+    }
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <eigen3/Eigen/Core>
+#include "so3Vec.h"
 
 Eigen::Matrix3d so3_vec(const Eigen::Vector3d& X) {
   Eigen::Matrix3d g;
@@ -35,6 +36,24 @@ TEST(So3VecTest, HandlesNonZeroVector) {
   EXPECT_EQ(result, expected);
 }
 
+TEST(So3VecTest, FixedSizeOverloadsRoundTrip) {
+  Eigen::Vector3d v(1, 2, 3);
+  Eigen::Matrix3d expected;
+  expected << 0, -3, 2,
+              3, 0, -1,
+              -2, 1, 0;
+  Eigen::Matrix3d m = so3Vec(v);
+  EXPECT_EQ(m, expected);
+  EXPECT_EQ(skew(v), expected);
+
+  Eigen::Vector3d back = so3Vec(m);
+  EXPECT_EQ(back, v);
+
+  // Dynamic-size input still goes through the MatrixXd version
+  Eigen::MatrixXd dyn = so3Vec(Eigen::MatrixXd(v));
+  EXPECT_EQ(dyn, Eigen::MatrixXd(expected));
+}
+
 int main(int argc, char **argv)
 {
     testing::InitGoogleTest(&argc, argv);
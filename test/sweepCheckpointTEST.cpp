@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+#include "sweepCheckpoint.h"
+#include "monteCarloSweep.h"
+
+std::string checkpointPath(const std::string &name) {
+    std::string path = (std::filesystem::temp_directory_path() / name).string();
+    std::remove(path.c_str());
+    return path;
+}
+
+// Resumable sweep whose cells draw from their streams, counting the runs
+Eigen::MatrixXd runSweep(SweepCheckpoint &checkpoint, int num_trials, Eigen::MatrixXi &runs,
+                         SweepProgress *last = nullptr) {
+    int num_rates = 4;
+    Eigen::MatrixXd result = Eigen::MatrixXd::Zero(num_rates, num_trials);
+    runs = Eigen::MatrixXi::Zero(num_rates, num_trials);
+
+    ThreadPool pool(2);
+    monteCarloSweep(pool, checkpoint, num_trials, num_rates, [&](const SweepCell &cell) {
+        RngStream rng = cell.stream(RngPurpose::Data);
+        runs(cell.rate, cell.trial) += 1;
+        return std::vector<double>{rng.normal(), rng.normal()};
+    }, [&](const SweepCell &cell, const std::vector<double> &v) {
+        result(cell.rate, cell.trial) = v[0] + v[1];
+    }, [&](const SweepProgress &p) {
+        if (last) {
+            *last = p;
+        }
+    });
+    return result;
+}
+
+TEST(SweepCheckpointTest, StoresAndFindsCells) {
+    std::string path = checkpointPath("sweepCheckpointTEST_store.ckpt");
+    {
+        SweepCheckpoint checkpoint(path, 7, 42);
+        ASSERT_EQ(checkpoint.size(), 0);
+        checkpoint.append(0, 1, {1.0, 2.0, 3.0});
+        checkpoint.append(2, 0, {});
+    }
+
+    SweepCheckpoint checkpoint(path, 7, 42);
+    std::vector<double> values;
+    ASSERT_EQ(checkpoint.size(), 2);
+    ASSERT_TRUE(checkpoint.find(0, 1, values));
+    ASSERT_EQ(values, std::vector<double>({1.0, 2.0, 3.0}));
+    ASSERT_TRUE(checkpoint.find(2, 0, values));
+    ASSERT_TRUE(values.empty());
+    ASSERT_FALSE(checkpoint.find(1, 1, values));
+
+    // Other configurations and seeds in the same file are ignored
+    SweepCheckpoint other_config(path, 8, 42), other_seed(path, 7, 43);
+    ASSERT_EQ(other_config.size(), 0);
+    ASSERT_EQ(other_seed.size(), 0);
+    std::remove(path.c_str());
+}
+
+TEST(SweepCheckpointTest, DropsTornRecord) {
+    std::string path = checkpointPath("sweepCheckpointTEST_torn.ckpt");
+    {
+        SweepCheckpoint checkpoint(path, 7, 42);
+        checkpoint.append(0, 0, {1.0});
+        checkpoint.append(0, 1, {2.0});
+    }
+
+    // Cut the last record as a crash during the write would
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 5);
+    {
+        SweepCheckpoint checkpoint(path, 7, 42);
+        ASSERT_EQ(checkpoint.size(), 1);
+        checkpoint.append(0, 1, {3.0});
+    }
+
+    SweepCheckpoint checkpoint(path, 7, 42);
+    std::vector<double> values;
+    ASSERT_EQ(checkpoint.size(), 2);
+    ASSERT_TRUE(checkpoint.find(0, 1, values));
+    ASSERT_EQ(values[0], 3.0);
+    std::remove(path.c_str());
+}
+
+TEST(SweepCheckpointTest, ResumedSweepMatchesFullSweep) {
+    std::string path = checkpointPath("sweepCheckpointTEST_resume.ckpt");
+    Eigen::MatrixXi runs;
+    Eigen::MatrixXd full, resumed;
+    {
+        SweepCheckpoint checkpoint(checkpointPath("sweepCheckpointTEST_full.ckpt"), 1, 5);
+        full = runSweep(checkpoint, 6, runs);
+    }
+
+    // A first run stops after 3 of the 6 trials
+    {
+        SweepCheckpoint checkpoint(path, 1, 5);
+        runSweep(checkpoint, 3, runs);
+        ASSERT_TRUE((runs.array() == 1).all());
+    }
+
+    // The restart only runs the missing trials
+    SweepCheckpoint checkpoint(path, 1, 5);
+    SweepProgress last = {0, 0, 0.0};
+    resumed = runSweep(checkpoint, 6, runs, &last);
+    ASSERT_TRUE((runs.leftCols(3).array() == 0).all());
+    ASSERT_TRUE((runs.rightCols(3).array() == 1).all());
+    ASSERT_EQ(last.resumed, 12);
+    ASSERT_EQ(last.done, 24);
+    ASSERT_TRUE(resumed == full);
+
+    std::remove(path.c_str());
+    std::remove(checkpointPath("sweepCheckpointTEST_full.ckpt").c_str());
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
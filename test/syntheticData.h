@@ -0,0 +1,103 @@
+/*
+DESCRIPTION:
+
+Synthetic AXB = YCZ data for the solver tests. syntheticData draws X, Y
+and Z, then for each cluster one fixed pose and samples of the varying
+poses, with B computed from the calibration equation:
+
+  cluster 1: A fixed, C_k varies,  B_k = X^{-1} A^{-1} Y C_k Z
+  cluster 2: C fixed, A_k varies,  B_k = X^{-1} A_k^{-1} Y C Z
+  cluster 3: B fixed, C_k varies,  A_k = Y C_k Z B^{-1} X^{-1}
+
+The varying poses are exp(spread * xi) with xi uniform in [-1, 1)^6. With
+noise > 0, the B samples of clusters 1 and 2 are multiplied by
+exp(noise * xi). The B-fixed clusters are only drawn when fixed_b is set.
+All draws come from one RngStream, so the data only depend on the seed.
+
+Input:
+    seed: seed of the RngStream
+    params: number of clusters and samples, spread, noise, fixed_b
+Output:
+    X, Y, Z: Matrices - dim 4x4
+    A1, B1, C1, A2, B2, C2, A3, B3, C3: clusters of Matrices - dim 4x4
+*/
+
+#ifndef SYNTHETICDATA_H
+#define SYNTHETICDATA_H
+
+#include <vector>
+#include <eigen3/Eigen/Dense>
+#include "rng.h"
+#include "se3ExpLog.h"
+#include "SE3.h"
+
+struct SyntheticDataParams {
+    int clusters = 3;
+    int samples = 20;
+    double spread = 1.0;
+    double noise = 0.0;
+    bool fixed_b = false;
+};
+
+struct SyntheticData {
+    Eigen::Matrix4d X, Y, Z;
+    std::vector<std::vector<Eigen::Matrix4d>> A1, B1, C1, A2, B2, C2, A3, B3, C3;
+};
+
+// exp(scale * xi) with xi uniform in [-1, 1)^6
+inline Eigen::Matrix4d randomPose(RngStream& rng, double scale = 1.0) {
+    Eigen::Matrix<double, 6, 1> xi;
+    fillUniform(xi, rng);
+    return se3Exp(scale * xi);
+}
+
+inline SyntheticData syntheticData(uint64_t seed,
+                                   const SyntheticDataParams& params = SyntheticDataParams()) {
+    RngStream rng(seed, 0, rngStreamId(RngPurpose::Data));
+    SyntheticData d;
+    d.X = randomPose(rng);
+    d.Y = randomPose(rng);
+    d.Z = randomPose(rng);
+    Eigen::Matrix4d X_inv = SE3inv(d.X);
+
+    int G = params.clusters;
+    for (auto* cluster : {&d.A1, &d.B1, &d.C1, &d.A2, &d.B2, &d.C2}) {
+        cluster->resize(G);
+    }
+    if (params.fixed_b) {
+        for (auto* cluster : {&d.A3, &d.B3, &d.C3}) {
+            cluster->resize(G);
+        }
+    }
+
+    auto noise = [&]() {
+        return params.noise > 0 ? randomPose(rng, params.noise) : Eigen::Matrix4d::Identity();
+    };
+
+    for (int g = 0; g < G; ++g) {
+        Eigen::Matrix4d A_fixed = randomPose(rng);
+        Eigen::Matrix4d C_fixed = randomPose(rng);
+        Eigen::Matrix4d B_fixed = params.fixed_b ? randomPose(rng) : Eigen::Matrix4d::Identity();
+        for (int k = 0; k < params.samples; ++k) {
+            Eigen::Matrix4d C = randomPose(rng, params.spread);
+            d.A1[g].push_back(A_fixed);
+            d.C1[g].push_back(C);
+            d.B1[g].push_back(X_inv * SE3inv(A_fixed) * d.Y * C * d.Z * noise());
+
+            Eigen::Matrix4d A = randomPose(rng, params.spread);
+            d.A2[g].push_back(A);
+            d.C2[g].push_back(C_fixed);
+            d.B2[g].push_back(X_inv * SE3inv(A) * d.Y * C_fixed * d.Z * noise());
+
+            if (params.fixed_b) {
+                C = randomPose(rng, params.spread);
+                d.C3[g].push_back(C);
+                d.B3[g].push_back(B_fixed);
+                d.A3[g].push_back(d.Y * C * d.Z * SE3inv(B_fixed) * X_inv);
+            }
+        }
+    }
+    return d;
+}
+
+#endif
@@ -0,0 +1,72 @@
+/*
+DESCRIPTION:
+
+The functions SE3inv, SE3Ad, and SE3Adinv are used to perform operations on elements of the
+ Special Euclidean group SE(3), which represents rigid body transformations in 3D space.
+
+SE3inv computes the inverse of an element of SE(3). Given a transformation matrix X that
+ represents a rotation and translation in 3D space, SE3inv(X) returns the transformation
+ matrix that “undoes” the transformation represented by X. It uses R^T and -R^T t, so the
+ result is again a rigid transformation with an exact bottom row, and should be used instead
+ of the general .inverse() for every rigid transformation.
+
+SE3Ad computes the adjoint representation of an element of SE(3). Given a transformation
+ matrix X, SE3Ad(X) returns a 6x6 matrix that can be used to transform spatial motion vectors
+ (e.g., twists) from one coordinate frame to another.
+
+SE3Adinv computes the inverse of the adjoint representation of an element of SE(3). Given a
+ transformation matrix X, SE3Adinv(X) returns a 6x6 matrix that can be used to transform
+ spatial motion vectors from one coordinate frame to another, in the opposite direction as SE3Ad(X).
+
+Twists are ordered as in se3Vec: [w; v]. The functions keep the scalar
+type of X (float or double).
+
+Input:
+    X: Matrix dim 4x4
+Output:
+    SE3inv: Matrix dim 4x4
+    SE3Ad, SE3Adinv: Matrix dim 6x6
+*/
+
+#ifndef SE3_H
+#define SE3_H
+
+#include <eigen3/Eigen/Dense>
+#include "so3Vec.h"
+
+template <typename Derived>
+Eigen::Matrix<typename Derived::Scalar, 4, 4> SE3inv(const Eigen::MatrixBase<Derived>& X_in) {
+    typedef typename Derived::Scalar Scalar;
+    const Eigen::Matrix<Scalar, 4, 4> X = X_in;
+    Eigen::Matrix<Scalar, 4, 4> invX;
+    invX.template block<3,3>(0,0) = X.template block<3,3>(0,0).transpose();
+    invX.template block<3,1>(0,3).noalias() = -invX.template block<3,3>(0,0) * X.template block<3,1>(0,3);
+    invX.row(3) << 0, 0, 0, 1;
+    return invX;
+}
+
+template <typename Derived>
+Eigen::Matrix<typename Derived::Scalar, 6, 6> SE3Ad(const Eigen::MatrixBase<Derived>& X) {
+    typedef typename Derived::Scalar Scalar;
+    Eigen::Matrix<Scalar, 3, 3> R = X.template block<3,3>(0,0);
+    Eigen::Matrix<Scalar, 3, 1> t = X.template block<3,1>(0,3);
+
+    Eigen::Matrix<Scalar, 6, 6> A;
+    A << R, Eigen::Matrix<Scalar, 3, 3>::Zero(),
+            skew(t) * R, R;
+    return A;
+}
+
+template <typename Derived>
+Eigen::Matrix<typename Derived::Scalar, 6, 6> SE3Adinv(const Eigen::MatrixBase<Derived>& X) {
+    typedef typename Derived::Scalar Scalar;
+    Eigen::Matrix<Scalar, 3, 3> R = X.template block<3,3>(0,0);
+    Eigen::Matrix<Scalar, 3, 1> t = X.template block<3,1>(0,3);
+
+    Eigen::Matrix<Scalar, 6, 6> A;
+    A << R.transpose(), Eigen::Matrix<Scalar, 3, 3>::Zero(),
+            -(skew(R.transpose() * t)) * R.transpose(), R.transpose();
+    return A;
+}
+
+#endif
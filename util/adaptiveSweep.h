@@ -0,0 +1,209 @@
+/*
+DESCRIPTION:
+
+The program defines adaptiveSweep, a Monte Carlo sweep over the rates
+(scramble rates, covariance coefficients, ...) of a simulation in which
+the number of trials of each rate is not fixed but follows the spread
+of its results.
+
+RunningStats keeps the running mean and variance of the values of the
+trials of one rate (Welford's algorithm) and the half-width of their
+confidence interval, z * sqrt(variance / count). A rate has converged
+when the half-width of each tracked value is below
+max(abs_tol, rel_tol * |mean|).
+
+The sweep runs in rounds. The first round runs min_trials trials of
+every rate. Every following round only runs trials of the rates that
+have not converged and have fewer than max_trials trials: as many as the
+current variance says are needed to reach the target, at most doubling
+the count of the rate, and at least one. All trials of a round run in
+parallel on the pool, so the workers always go to the unconverged rates.
+The statistics are updated after each round in (rate, trial) order, and
+trial n of a rate is the cell (n, rate) of monteCarloSweep with the same
+random streams, so the result does not depend on the number of threads.
+
+The overload taking a SweepCheckpoint reads back the cells found in the
+checkpoint and appends the new ones, as the resumable monteCarloSweep.
+
+Input:
+    pool: thread pool running the trials
+    seed: seed of all random streams
+    num_rates: number of rates
+    cell: callable taking a const SweepCell& and returning the values of
+          the trial as a std::vector<double>
+    params: trial counts, tolerances, z and the tracked values
+Output:
+    RunningStats of each rate
+*/
+
+#ifndef ADAPTIVESWEEP_H
+#define ADAPTIVESWEEP_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+#include "monteCarloSweep.h"
+#include "sweepCheckpoint.h"
+
+class RunningStats {
+public:
+    void add(const Eigen::VectorXd &x) {
+        if (count_ == 0) {
+            mean_ = Eigen::VectorXd::Zero(x.size());
+            m2_ = Eigen::VectorXd::Zero(x.size());
+        }
+        ++count_;
+        Eigen::VectorXd delta = x - mean_;
+        mean_ += delta / count_;
+        m2_ += delta.cwiseProduct(x - mean_);
+    }
+
+    int count() const {
+        return count_;
+    }
+
+    const Eigen::VectorXd &mean() const {
+        return mean_;
+    }
+
+    // Sample variance
+    Eigen::VectorXd variance() const {
+        if (count_ < 2) {
+            return Eigen::VectorXd::Zero(mean_.size());
+        }
+        return m2_ / (count_ - 1);
+    }
+
+    // Half-width of the confidence interval of the mean
+    Eigen::VectorXd halfWidth(double z = 1.96) const {
+        if (count_ == 0) {
+            return mean_;
+        }
+        return z * (variance() / count_).cwiseSqrt();
+    }
+
+private:
+    int count_ = 0;
+    Eigen::VectorXd mean_;
+    Eigen::VectorXd m2_;
+};
+
+struct AdaptiveSweepParams {
+    int min_trials = 5;
+    int max_trials = 50;
+    double abs_tol = 0.0;       // target half-width
+    double rel_tol = 0.1;       // target half-width relative to |mean|
+    double z = 1.96;            // 95 % interval
+    std::vector<int> tracked;   // values tested for convergence, empty for all
+
+    // Number of trials the rate should have to reach the target, or its
+    // current count when it has converged
+    int trialsNeeded(const RunningStats &stats) const {
+        Eigen::VectorXd mean = stats.mean();
+        Eigen::VectorXd hw = stats.halfWidth(z);
+        double ratio = 0.0;
+        for (int k = 0; k < mean.size(); ++k) {
+            if (!tracked.empty() && std::find(tracked.begin(), tracked.end(), k) == tracked.end()) {
+                continue;
+            }
+            double target = std::max(abs_tol, rel_tol * std::abs(mean(k)));
+            if (hw(k) <= target) {
+                continue;
+            }
+            ratio = target > 0 ? std::max(ratio, hw(k) / target) : HUGE_VAL;
+        }
+        if (ratio == 0.0) {
+            return stats.count();
+        }
+        // The half-width decreases as 1 / sqrt(count)
+        double needed = std::ceil(stats.count() * ratio * ratio);
+        return needed < max_trials ? std::max(static_cast<int>(needed), stats.count() + 1) : max_trials;
+    }
+};
+
+template <typename Cell>
+std::vector<RunningStats> runAdaptiveSweep(ThreadPool &pool,
+                                           uint64_t seed,
+                                           SweepCheckpoint *checkpoint,
+                                           int num_rates,
+                                           Cell cell,
+                                           const AdaptiveSweepParams &params,
+                                           const std::function<void(const SweepProgress &)> &report,
+                                           double report_seconds) {
+    std::vector<RunningStats> stats(num_rates);
+    std::vector<int> target(num_rates, std::max(params.min_trials, 2));
+
+    while (true) {
+        // Trials of this round
+        std::vector<SweepCell> round;
+        for (int rk = 0; rk < num_rates; ++rk) {
+            for (int n = stats[rk].count(); n < std::min(target[rk], params.max_trials); ++n) {
+                round.push_back(SweepCell{seed, n, rk});
+            }
+        }
+        if (round.empty()) {
+            break;
+        }
+
+        // Position in the round of the first new trial of each rate
+        std::vector<int> offset(num_rates, 0);
+        for (int i = round.size() - 1; i >= 0; --i) {
+            offset[round[i].rate] = i;
+        }
+
+        std::vector<std::vector<double>> values(round.size());
+        std::vector<SweepCell> cells;
+        int resumed = 0;
+        for (size_t i = 0; i < round.size(); ++i) {
+            if (checkpoint && checkpoint->find(round[i].trial, round[i].rate, values[i])) {
+                ++resumed;
+            } else {
+                cells.push_back(round[i]);
+            }
+        }
+
+        auto task = [&](const SweepCell &c) {
+            std::vector<double> v = cell(c);
+            if (checkpoint) {
+                checkpoint->append(c.trial, c.rate, v);
+            }
+            values[offset[c.rate] + c.trial - stats[c.rate].count()] = std::move(v);
+        };
+        runSweepCells(pool, cells, round.size(), resumed, task, report, report_seconds);
+
+        // Update the statistics in (rate, trial) order and plan the next round
+        for (size_t i = 0; i < round.size(); ++i) {
+            stats[round[i].rate].add(Eigen::Map<const Eigen::VectorXd>(values[i].data(), values[i].size()));
+        }
+        for (int rk = 0; rk < num_rates; ++rk) {
+            int count = stats[rk].count();
+            target[rk] = std::min(params.trialsNeeded(stats[rk]), 2 * count);
+        }
+    }
+    return stats;
+}
+
+template <typename Cell>
+std::vector<RunningStats> adaptiveSweep(ThreadPool &pool,
+                                        uint64_t seed,
+                                        int num_rates,
+                                        Cell cell,
+                                        const AdaptiveSweepParams &params = AdaptiveSweepParams(),
+                                        const std::function<void(const SweepProgress &)> &report = printSweepProgress,
+                                        double report_seconds = 1.0) {
+    return runAdaptiveSweep(pool, seed, nullptr, num_rates, cell, params, report, report_seconds);
+}
+
+template <typename Cell>
+std::vector<RunningStats> adaptiveSweep(ThreadPool &pool,
+                                        SweepCheckpoint &checkpoint,
+                                        int num_rates,
+                                        Cell cell,
+                                        const AdaptiveSweepParams &params = AdaptiveSweepParams(),
+                                        const std::function<void(const SweepProgress &)> &report = printSweepProgress,
+                                        double report_seconds = 1.0) {
+    return runAdaptiveSweep(pool, checkpoint.seed(), &checkpoint, num_rates, cell, params, report, report_seconds);
+}
+
+#endif
@@ -0,0 +1,110 @@
+/*
+DESCRIPTION:
+
+The program defines CompactPoses, a sequence of rigid transformations
+stored as a unit quaternion and a translation each. A pose takes 7
+doubles (56 bytes) instead of the 16 of a Matrix4d (128 bytes), which
+matters for data sets with millions of poses.
+
+X[i] converts pose i to a Matrix4d on the fly, so CompactPoses can be
+used wherever a solver only reads the poses by index and asks for
+size(): meanCov, PoseStats, PoseArray, metric, the axbyczProb solvers
+and axbyczProbN. rotation(i) and translation(i) are views of the
+stored coefficients without any conversion. loadMatrices and
+generateABC can fill a CompactPoses directly.
+
+Input:
+    X: vector of Matrices dim 4x4, or poses added with push_back / set
+Output:
+    X[i]: Matrix dim 4x4
+*/
+
+#ifndef COMPACTPOSES_H
+#define COMPACTPOSES_H
+
+#include <vector>
+#include <eigen3/Eigen/Dense>
+#include <eigen3/Eigen/Geometry>
+
+class CompactPoses {
+public:
+    CompactPoses() {}
+
+    // N identity poses
+    explicit CompactPoses(int N) : data_(7 * N, 0.0) {
+        for (int i = 0; i < N; ++i) {
+            data_[7 * i + 3] = 1.0;
+        }
+    }
+
+    explicit CompactPoses(const std::vector<Eigen::Matrix4d> &X) : data_(7 * X.size()) {
+        for (size_t i = 0; i < X.size(); ++i) {
+            set(i, X[i]);
+        }
+    }
+
+    int size() const {
+        return data_.size() / 7;
+    }
+
+    void reserve(int N) {
+        data_.reserve(7 * N);
+    }
+
+    void push_back(const Eigen::Matrix4d &X) {
+        data_.resize(data_.size() + 7);
+        set(size() - 1, X);
+    }
+
+    void set(int i, const Eigen::Matrix4d &X) {
+        Eigen::Quaterniond q(Eigen::Matrix3d(X.block<3, 3>(0, 0)));
+        q.normalize();
+        // Same rotation, stored with w >= 0
+        if (q.w() < 0) {
+            q.coeffs() = -q.coeffs();
+        }
+        Eigen::Map<Eigen::Quaterniond> rotation(&data_[7 * i]);
+        Eigen::Map<Eigen::Vector3d> translation(&data_[7 * i + 4]);
+        rotation = q;
+        translation = X.block<3, 1>(0, 3);
+    }
+
+    Eigen::Map<const Eigen::Quaterniond> rotation(int i) const {
+        return Eigen::Map<const Eigen::Quaterniond>(&data_[7 * i]);
+    }
+
+    Eigen::Map<const Eigen::Vector3d> translation(int i) const {
+        return Eigen::Map<const Eigen::Vector3d>(&data_[7 * i + 4]);
+    }
+
+    Eigen::Matrix4d operator[](int i) const {
+        Eigen::Matrix4d X;
+        X.block<3, 3>(0, 0) = rotation(i).toRotationMatrix();
+        X.block<3, 1>(0, 3) = translation(i);
+        X.row(3) << 0, 0, 0, 1;
+        return X;
+    }
+
+    std::vector<Eigen::Matrix4d> toMatrices() const {
+        std::vector<Eigen::Matrix4d> X(size());
+        for (int i = 0; i < size(); ++i) {
+            X[i] = (*this)[i];
+        }
+        return X;
+    }
+
+private:
+    // [qx qy qz qw tx ty tz] per pose
+    std::vector<double, Eigen::aligned_allocator<double>> data_;
+};
+
+// Store pose i of either kind of sequence
+inline void setPose(std::vector<Eigen::Matrix4d> &X, int i, const Eigen::Matrix4d &P) {
+    X[i] = P;
+}
+
+inline void setPose(CompactPoses &X, int i, const Eigen::Matrix4d &P) {
+    X.set(i, P);
+}
+
+#endif
@@ -37,6 +37,7 @@ Input:
 #include "sensorNoise.h"
 #include "se3Vec.h"
 #include "fKine.h"
+#include "SE3.h"
 
 std::tuple<std::vector<Eigen::Matrix4d>, std::vector<Eigen::Matrix4d>, std::vector<Eigen::Matrix4d>>
 generateABC(int length, int optFix, int optPDF, const Eigen::VectorXd& M, const Eigen::MatrixXd& Sig,
@@ -88,6 +89,11 @@ generateABC(int length, int optFix, int optPDF, const Eigen::VectorXd& M, const
         C_initial = (Eigen::Matrix4d(se3Vec(c))).exp();
     }
 
+    // Inverses of the ground truths, computed once
+    Eigen::Matrix4d X_inv = SE3inv(X);
+    Eigen::Matrix4d Y_inv = SE3inv(Y);
+    Eigen::Matrix4d Z_inv = SE3inv(Z);
+
     //PART II - Fix a matrix A, B, C - Only using Gaussian noise - optPDF = 1
 
     if (optFix == 1) { // Fix A, randomize B and C - This can be applied to both serial-parallel and dual-robot arm calibrations
@@ -109,7 +115,7 @@ generateABC(int length, int optFix, int optPDF, const Eigen::VectorXd& M, const
                 B[m] = *(sensor_output.first);
             }*/
             // Compute C matrix from A,B,X,Y,Z matrices
-            C[m] = Y.inverse() * (A_initial * X * B[m] * Z.inverse());
+            C[m] = Y_inv * (A_initial * X * B[m] * Z_inv);
             // Assign fixed value to A matrix
             A[m] = A_initial;
         }
@@ -125,7 +131,7 @@ generateABC(int length, int optFix, int optPDF, const Eigen::VectorXd& M, const
                 gmean << 0, 0, 0, 0, 0, 0;
                 A[m] = sensorNoise(A_initial, gmean, Sig(0), 1);
             }*/
-            C[m] = Y.inverse() * (A[m] * X * B_initial * Z.inverse());
+            C[m] = Y_inv * (A[m] * X * B_initial * Z_inv);
             B[m] = B_initial;
         }
     } else if (optFix == 3) {// Fix C, randomize A and B - This is only physically achievable on multi-robot hand-eye calibration
@@ -143,8 +149,8 @@ generateABC(int length, int optFix, int optPDF, const Eigen::VectorXd& M, const
             }*/
             Eigen::VectorXd randVec = mvg(M, Sig, 1).first;
             B_inv[m] = (Eigen::MatrixXd(se3Vec(randVec)).exp() * B_initial);
-            B[m] = B_inv[m].inverse();
-            A[m] = (Y * C_initial * Z * B[m].inverse()) * X.inverse();
+            B[m] = SE3inv(B_inv[m]);
+            A[m] = (Y * C_initial * Z * B_inv[m]) * X_inv;
             C[m] = C_initial;
         }
     } else if (optFix == 4) { // This is for testing traditional AXBYCZ solver that demands the - correspondence between the data pairs {A_i, B_i, C_i}
@@ -152,7 +158,7 @@ generateABC(int length, int optFix, int optPDF, const Eigen::VectorXd& M, const
             Eigen::VectorXd randVec = mvg(M, Sig, 1).first;
             A[m] = (Eigen::MatrixXd(se3Vec(randVec)).exp() * C_initial);
             C[m] = (Eigen::MatrixXd(se3Vec(randVec)).exp() * C_initial);
-            B[m] = X.inverse() * (A[m].inverse() * Y * C[m] * Z);
+            B[m] = X_inv * (SE3inv(A[m]) * Y * C[m] * Z);
         }
     }
     // Return a tuple of vectors containing the output matrices
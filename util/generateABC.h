@@ -12,7 +12,8 @@ including Eigen, which is a library for linear algebra in C++, and
 mvg and sensorNoise, which are libraries for computer vision and 
 sensor noise modeling, respectively.
 
-Data generation for AXB = YCZ problem
+Data generation for AXB = YCZ problem. The perturbations of all poses
+are drawn in one batch from a single MultivariateGaussian.
 Input:
        length: number of generated data pairs
        optFix: option for fixing different data streams
@@ -20,9 +21,12 @@ Input:
        M:      mean of perturbance in lie algebra
        Sig:    covariance of perturbance in lie algebra
        X, Y, Z: ground truths
+       rng:    random stream of the data set (rng.h), defaultRngStream()
+               when omitted
  Output:
        A, B, C: 4 x 4 x length or 4 x 4
-                noise-free data streams with correspondence
+                noise-free data streams with correspondence, as vectors of
+                Matrix4d or, with generateABC<CompactPoses>, as CompactPoses
 */
 
 #ifndef GENERATEABC_H
@@ -37,11 +41,15 @@ Input:
 #include <tuple>
 #include <vector>
 #include "mvg.h"
+#include "rng.h"
 #include "sensorNoise.h"
 #include "se3Vec.h"
 #include "fKine.h"
+#include "SE3.h"
+#include "compactPoses.h"
 
-std::tuple<std::vector<Eigen::Matrix4d>, std::vector<Eigen::Matrix4d>, std::vector<Eigen::Matrix4d>>
+template <typename Sequence = std::vector<Eigen::Matrix4d>>
+std::tuple<Sequence, Sequence, Sequence>
 generateABC(int length,
             int optFix,
             int optPDF,
@@ -49,10 +57,12 @@ generateABC(int length,
             const Eigen::MatrixXd& Sig,
             const Eigen::Matrix4d& X,
             const Eigen::Matrix4d& Y,
-            const Eigen::Matrix4d& Z)
+            const Eigen::Matrix4d& Z,
+            RngStream& rng)
 {
     int dataGenMode = 3;
-    std::vector<Eigen::Matrix4d> A(length), B(length), C(length);
+    Sequence A(length), B(length), C(length);
+    Eigen::Matrix4d A_m, B_m, C_m;
     Eigen::Matrix4d A_initial, B_initial, C_initial;
 
     Eigen::VectorXd qz1(6);
@@ -87,14 +97,28 @@ generateABC(int length,
 
     } else if (dataGenMode == 3) {
 
-        Eigen::VectorXd a = Eigen::VectorXd::Random(6).normalized();
-        A_initial = (Eigen::Matrix4d(se3Vec(a))).exp();
+        Eigen::Matrix<double, 6, 1> a, b, c;
+        fillUniform(a, rng);
+        A_initial = se3Vec(a.normalized()).exp();
+
+        fillUniform(b, rng);
+        B_initial = se3Vec(b.normalized()).exp();
 
-        Eigen::VectorXd b = Eigen::VectorXd::Random(6).normalized();
-        B_initial = (Eigen::Matrix4d(se3Vec(b))).exp();
+        fillUniform(c, rng);
+        C_initial = se3Vec(c.normalized()).exp();
+    }
 
-        Eigen::VectorXd c = Eigen::VectorXd::Random(6).normalized();
-        C_initial = (Eigen::Matrix4d(se3Vec(c))).exp();
+    // Inverses of the ground truths, computed once
+    Eigen::Matrix4d X_inv = SE3inv(X);
+    Eigen::Matrix4d Y_inv = SE3inv(Y);
+    Eigen::Matrix4d Z_inv = SE3inv(Z);
+
+    // Perturbations in the lie algebra, all drawn at once. Fixing C takes
+    // two per pose, the other options one.
+    MultivariateGaussian gaussian(M, Sig, rng);
+    Eigen::MatrixXd randVecs;
+    if (length > 0) {
+        gaussian.sample(optFix == 3 ? 2 * length : length, randVecs, rng);
     }
 
     //PART II - Fix a matrix A, B, C - Only using Gaussian noise - optPDF = 1
@@ -102,9 +126,10 @@ generateABC(int length,
     if (optFix == 1) { // Fix A, randomize B and C - This can be applied to both serial-parallel and dual-robot arm calibrations
         for (int m = 0; m < length; m++) {
             if (optPDF == 1) {
-                Eigen::VectorXd randVec = mvg(M, Sig, 1).first;
+                Eigen::Matrix<double, 6, 1> randVec = randVecs.col(m);
                 // Update B matrix with random noise
-                B[m] = (Eigen::MatrixXd(se3Vec(randVec)).exp() * B_initial);
+                B_m = se3Vec(randVec).exp() * B_initial;
+                setPose(B, m, B_m);
             }
             /*else if (optPDF == 2){
                 Eigen::Matrix<double, 6, 1> randVec = mvg(M, Sig, 1);
@@ -118,15 +143,16 @@ generateABC(int length,
                 B[m] = *(sensor_output.first);
             }*/
             // Compute C matrix from A,B,X,Y,Z matrices
-            C[m] = Y.inverse() * (A_initial * X * B[m] * Z.inverse());
+            setPose(C, m, Y_inv * (A_initial * X * B_m * Z_inv));
             // Assign fixed value to A matrix
-            A[m] = A_initial;
+            setPose(A, m, A_initial);
         }
     } else if (optFix == 2) { // Fix B, randomize A and C - This can be applied to both serial-parallel and dual-robot arm calibrations
         for (int m = 0; m < length; m++) {
             if (optPDF == 1) {
-                Eigen::VectorXd randVec = mvg(M, Sig, 1).first;
-                A[m] = (Eigen::MatrixXd(se3Vec(randVec)).exp() * C_initial);
+                Eigen::Matrix<double, 6, 1> randVec = randVecs.col(m);
+                A_m = se3Vec(randVec).exp() * C_initial;
+                setPose(A, m, A_m);
             } /*else if(optPDF == 2) {
             A[m] = (A_initial * Eigen::Matrix4d(se3Vec(mvg(M, Sig, 1))).exp());
             } else if(optPDF == 3) {
@@ -134,15 +160,15 @@ generateABC(int length,
                 gmean << 0, 0, 0, 0, 0, 0;
                 A[m] = sensorNoise(A_initial, gmean, Sig(0), 1);
             }*/
-            C[m] = Y.inverse() * (A[m] * X * B_initial * Z.inverse());
-            B[m] = B_initial;
+            setPose(C, m, Y_inv * (A_m * X * B_initial * Z_inv));
+            setPose(B, m, B_initial);
         }
     } else if (optFix == 3) {// Fix C, randomize A and B - This is only physically achievable on multi-robot hand-eye calibration
         Eigen::Matrix4d B_inv[length];
         for (int m = 0; m < length; m++) {
             if (optPDF == 1) {
-                Eigen::VectorXd randVec = mvg(M, Sig, 1).first;
-                B[m] = (Eigen::MatrixXd(se3Vec(randVec)).exp() * B_initial);
+                Eigen::Matrix<double, 6, 1> randVec = randVecs.col(2 * m);
+                setPose(B, m, se3Vec(randVec).exp() * B_initial);
             } /*else if (optPDF == 2) {
             B[m] = (B_initial * Eigen::Matrix4d(se3Vec(mvg(M, Sig, 1))).exp());
             } else if (optPDF == 3) {
@@ -150,22 +176,39 @@ generateABC(int length,
                 gmean << 0, 0, 0, 0, 0, 0;
                 B[m] = sensorNoise(B_initial, gmean, Sig(0), 1);
             }*/
-            Eigen::VectorXd randVec = mvg(M, Sig, 1).first;
-            B_inv[m] = (Eigen::MatrixXd(se3Vec(randVec)).exp() * B_initial);
-            B[m] = B_inv[m].inverse();
-            A[m] = (Y * C_initial * Z * B[m].inverse()) * X.inverse();
-            C[m] = C_initial;
+            Eigen::Matrix<double, 6, 1> randVec = randVecs.col(2 * m + 1);
+            B_inv[m] = se3Vec(randVec).exp() * B_initial;
+            setPose(B, m, SE3inv(B_inv[m]));
+            setPose(A, m, (Y * C_initial * Z * B_inv[m]) * X_inv);
+            setPose(C, m, C_initial);
         }
     } else if (optFix == 4) { // This is for testing traditional AXBYCZ solver that demands the - correspondence between the data pairs {A_i, B_i, C_i}
         for (int m = 0; m < length; m++) {
-            Eigen::VectorXd randVec = mvg(M, Sig, 1).first;
-            A[m] = (Eigen::MatrixXd(se3Vec(randVec)).exp() * C_initial);
-            C[m] = (Eigen::MatrixXd(se3Vec(randVec)).exp() * C_initial);
-            B[m] = X.inverse() * (A[m].inverse() * Y * C[m] * Z);
+            Eigen::Matrix<double, 6, 1> randVec = randVecs.col(m);
+            A_m = se3Vec(randVec).exp() * C_initial;
+            C_m = se3Vec(randVec).exp() * C_initial;
+            setPose(A, m, A_m);
+            setPose(C, m, C_m);
+            setPose(B, m, X_inv * (SE3inv(A_m) * Y * C_m * Z));
         }
     }
     // Return a tuple of vectors containing the output matrices
     return std::make_tuple(A,B,C);
 }
 
+// Same, drawing from defaultRngStream()
+template <typename Sequence = std::vector<Eigen::Matrix4d>>
+std::tuple<Sequence, Sequence, Sequence>
+generateABC(int length,
+            int optFix,
+            int optPDF,
+            const Eigen::VectorXd& M,
+            const Eigen::MatrixXd& Sig,
+            const Eigen::Matrix4d& X,
+            const Eigen::Matrix4d& Y,
+            const Eigen::Matrix4d& Z)
+{
+    return generateABC<Sequence>(length, optFix, optPDF, M, Sig, X, Y, Z, defaultRngStream());
+}
+
 #endif
\ No newline at end of file
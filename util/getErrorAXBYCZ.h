@@ -27,13 +27,14 @@ refining the transformation to improve accuracy.
 #include "rotError.h"
 #include "tranError.h"
 
-Eigen::VectorXd getErrorAXBYCZ(const Eigen::Matrix4d& X_f,
-                               const Eigen::Matrix4d& Y_f,
-                               const Eigen::Matrix4d& Z_f,
-                               const Eigen::Matrix4d& XActual,
-                               const Eigen::Matrix4d& YActual,
-                               const Eigen::Matrix4d& ZActual) {
-    Eigen::VectorXd xyzError(6);
+template <typename Scalar>
+Eigen::Matrix<Scalar, Eigen::Dynamic, 1> getErrorAXBYCZ(const Eigen::Matrix<Scalar, 4, 4>& X_f,
+                                                        const Eigen::Matrix<Scalar, 4, 4>& Y_f,
+                                                        const Eigen::Matrix<Scalar, 4, 4>& Z_f,
+                                                        const Eigen::Matrix<Scalar, 4, 4>& XActual,
+                                                        const Eigen::Matrix<Scalar, 4, 4>& YActual,
+                                                        const Eigen::Matrix<Scalar, 4, 4>& ZActual) {
+    Eigen::Matrix<Scalar, Eigen::Dynamic, 1> xyzError(6);
 
     xyzError(0) = rotError(X_f, XActual);
     xyzError(1) = rotError(Y_f, YActual);
@@ -9,7 +9,8 @@ opt is 2, it sets the matrices X, Y, and Z to pre-defined values.
 If opt is 3, it sets the matrices X, Y, and Z to pre-defined rotation 
 matrices. If opt is not 1, 2, or 3, it outputs an error message. 
 The matrices X, Y, and Z represent the ground truth transformations 
-for a 3D pose estimation problem.
+for a 3D pose estimation problem. The random draws of opt 1 come from
+rng (rng.h), or from defaultRngStream() when it is omitted.
 */
 
 #ifndef INITIALIZEXYZ_H
@@ -21,23 +22,28 @@ for a 3D pose estimation problem.
 #include <eigen3/Eigen/Geometry>
 #include <se3Vec.h>
 #include <expm.h>
+#include "rng.h"
 
 void initializeXYZ(int opt,
                    Eigen::Matrix4d& X,
                    Eigen::Matrix4d& Y,
-                   Eigen::Matrix4d& Z)
+                   Eigen::Matrix4d& Z,
+                   RngStream& rng)
 {
     if (opt == 1)
     {
-        Eigen::VectorXd x = Eigen::VectorXd::Random(6);
+        Eigen::Matrix<double, 6, 1> x;
+        fillUniform(x, rng);
         x.normalize();
         X = Eigen::Matrix4d::Identity() * expm(se3Vec(x));
         
-        Eigen::VectorXd y = Eigen::VectorXd::Random(6);
+        Eigen::Matrix<double, 6, 1> y;
+        fillUniform(y, rng);
         y.normalize();
         Y = Eigen::Matrix4d::Identity() * expm(se3Vec(y));
         
-        Eigen::VectorXd z = Eigen::VectorXd::Random(6);
+        Eigen::Matrix<double, 6, 1> z;
+        fillUniform(z, rng);
         z.normalize();
         Z = Eigen::Matrix4d::Identity() * expm(se3Vec(z));
     }
@@ -77,4 +83,12 @@ void initializeXYZ(int opt,
     }
 }
 
+void initializeXYZ(int opt,
+                   Eigen::Matrix4d& X,
+                   Eigen::Matrix4d& Y,
+                   Eigen::Matrix4d& Z)
+{
+    initializeXYZ(opt, X, Y, Z, defaultRngStream());
+}
+
 #endif
\ No newline at end of file
@@ -11,8 +11,11 @@
 #include <string>
 #include <vector>
 
+// Appends the matrices of the file to any sequence with push_back, e.g. a
+// vector of Matrix4d or a CompactPoses
+template <typename Sequence>
 void loadMatrices(const std::string& filepath,
-                  std::vector<Eigen::Matrix4d>& matrices) {
+                  Sequence& matrices) {
     Eigen::Matrix4d matrix;
     std::ifstream file(filepath);
     if (file.is_open()) {
@@ -30,4 +33,13 @@ void loadMatrices(const std::string& filepath,
     }
 }
 
+// Appends the matrices of every file in turn
+template <typename Sequence>
+void loadMatrices(const std::vector<std::string>& filepaths,
+                  Sequence& matrices) {
+    for (const auto& filepath : filepaths) {
+        loadMatrices(filepath, matrices);
+    }
+}
+
 #endif
\ No newline at end of file
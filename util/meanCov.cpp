@@ -2,16 +2,19 @@
 DESCRIPTION:
 
 This program defines several functions for calculating the mean
-and covariance of a set of 4x4 matrices. The log function takes
-a 4x4 matrix and calculates its matrix logarithm, while the vex
-function takes a 3x3 matrix and returns its vector of exteriorization.
-The meanCov function takes an array of 3x3 matrices and its size
-N and calculates the mean and covariance of the logarithms of those
-matrices. It does this by first taking the average of the logarithms
-using the expm function, then iteratively refining this average until
-convergence using the log and vex functions. Finally, it calculates
-the covariance by taking the vector of differences between each logarithm
-and the mean logarithm and computing their outer product.
+and covariance of a set of 4x4 matrices. The vex function takes
+a 3x3 matrix and returns its vector of exteriorization.
+The meanCov function takes an array of 4x4 rigid transformations
+and calculates the mean and covariance of their logarithms. It does
+this by first taking the average of the logarithms and mapping it
+back with the exponential, then iteratively refining this average
+until convergence. Finally, it calculates the covariance by taking
+the vector of differences between each sample and the mean and
+computing their outer product.
+
+The logarithms and exponentials are evaluated in closed form with
+se3Log and se3Exp, which work directly on 6x1 twists, instead of
+the general matrix functions from unsupported/Eigen/MatrixFunctions.
 
 Input:
     X: Matrix dim - 4x4 - pass by reference
@@ -26,52 +29,7 @@ Output:
 #include <cstdlib>
 #include <random>
 #include <Eigen/Dense>
-#include <unsupported/Eigen/MatrixFunctions>
-
-Eigen::Vector3d vex(const Eigen::Matrix3d &m) {
-    Eigen::Vector3d v;
-    v << m(2, 1), m(0, 2), m(1, 0);
-    return v;
-}
-
-void meanCov(const std::vector<Eigen::Matrix4d> &X,
-             Eigen::Matrix4d &Mean,
-             Eigen::Matrix<double, 6, 6> &Cov) {
-
-    int N = X.size();
-    Mean = Eigen::Matrix4d::Identity();
-    Cov = Eigen::Matrix<double, 6, 6>::Zero();
-
-    // Initial approximation of Mean
-    Eigen::Matrix4d sum_se = Eigen::Matrix4d::Zero();
-    for (int i = 0; i < N; i++) {
-        sum_se += X[i].log();
-    }
-    Mean = ((1.0 / N) * sum_se).exp();
-
-    // Iterative process to calculate the true Mean
-    Eigen::Matrix4d diff_se = Eigen::Matrix4d::Ones();
-    int max_num = 100;
-    double tol = 1e-5;
-    int count = 1;
-    while (diff_se.norm() >= tol && count <= max_num) {
-        diff_se = Eigen::Matrix4d::Zero();
-        for (int i = 0; i < N; i++) {
-            diff_se += (Mean.inverse() * X[i]).log();
-        }
-        Mean *= ((1.0 / N)* diff_se).exp();
-        count++;
-    }
-
-    // Covariance
-    for (int i = 0; i < N; i++) {
-        diff_se = (Mean.inverse() * X[i]).log();
-        Eigen::VectorXd diff_vex(6);
-        diff_vex << vex(diff_se.block<3, 3>(0, 0)), diff_se.block<3, 1>(0, 3);
-        Cov += diff_vex * diff_vex.transpose();
-    }
-    Cov /= N;
-}
+#include "meanCov.h"
 
 Eigen::Matrix3d randomRotationMatrix(std::default_random_engine &generator) {
     std::normal_distribution<double> distribution(0.0, 1.0);
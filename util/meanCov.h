@@ -2,26 +2,45 @@
 DESCRIPTION:
 
 This program defines several functions for calculating the mean
-and covariance of a set of 4x4 matrices. The log function takes
-a 4x4 matrix and calculates its matrix logarithm, while the vex
-function takes a 3x3 matrix and returns its vector of exteriorization.
-The meanCov function takes an array of 3x3 matrices and its size
-N and calculates the mean and covariance of the logarithms of those
-matrices. It does this by first taking the average of the logarithms
-using the expm function, then iteratively refining this average until
-convergence using the log and vex functions. Finally, it calculates
-the covariance by taking the vector of differences between each logarithm
-and the mean logarithm and computing their outer product.
+and covariance of a set of 4x4 matrices. The vex function takes
+a 3x3 matrix and returns its vector of exteriorization.
+The meanCov function takes an array of 4x4 rigid transformations
+and calculates the mean and covariance of their logarithms. It does
+this by first taking the average of the logarithms and mapping it
+back with the exponential, then iteratively refining this average
+until convergence. Finally, it calculates the covariance by taking
+the vector of differences between each sample and the mean and
+computing their outer product.
+
+The logarithms and exponentials are evaluated in closed form with
+se3Log and se3Exp, which work directly on 6x1 twists, instead of
+the general matrix functions from unsupported/Eigen/MatrixFunctions.
+
+meanCovParallel computes the same quantities with the three sums over
+the samples split across a ThreadPool. The per-chunk partial sums are
+combined in chunk order, so the result is bit-reproducible for a fixed
+pool size. If X has fewer than two grain_size chunks per pool the sums
+run on the calling thread and the result equals meanCov.
+
+X may be any sequence of poses with size() and X[i], e.g. a vector of
+Matrix4d, a CompactPoses or a PermutedPoses view. meanCov works in the
+scalar type of Mean and Cov (float or double) and converts the samples
+to it on the fly. In float, the convergence tolerance grows with N, as
+the rounding error of the sums does.
 */
 
 #ifndef MEANCOV_H
 #define MEANCOV_H
 
 #include <iostream>
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <Eigen/Dense>
 #include <vector>
-#include <unsupported/Eigen/MatrixFunctions>
+#include "se3ExpLog.h"
+#include "SE3.h"
+#include "threadPool.h"
 
 Eigen::Vector3d vex(const Eigen::Matrix3d &m) {
     Eigen::Vector3d v;
@@ -29,43 +48,104 @@ Eigen::Vector3d vex(const Eigen::Matrix3d &m) {
     return v;
 }
 
-void meanCov(const std::vector<Eigen::Matrix4d> &X,
-             Eigen::Matrix4d &Mean,
-             Eigen::Matrix<double, 6, 6> &Cov) {
+template <typename Sequence, typename Scalar>
+void meanCov(const Sequence &X,
+             Eigen::Matrix<Scalar, 4, 4> &Mean,
+             Eigen::Matrix<Scalar, 6, 6> &Cov) {
+
+    typedef Eigen::Matrix<Scalar, 6, 1> Vector6;
+    typedef Eigen::Matrix<Scalar, 4, 4> Matrix4;
 
     int N = X.size();
-    Mean = Eigen::Matrix4d::Identity();
-    Cov = Eigen::Matrix<double, 6, 6>::Zero();
+    Mean = Matrix4::Identity();
+    Cov = Eigen::Matrix<Scalar, 6, 6>::Zero();
 
     // Initial approximation of Mean
-    Eigen::Matrix4d sum_se = Eigen::Matrix4d::Zero();
+    Vector6 sum_se = Vector6::Zero();
     for (int i = 0; i < N; i++) {
-        sum_se += X[i].log();
+        sum_se += se3Log(X[i].template cast<Scalar>());
     }
-    Mean = ((1.0 / N) * sum_se).exp();
+    Mean = se3Exp((Scalar(1) / N) * sum_se);
 
-    // Iterative process to calculate the true Mean
-    Eigen::Matrix4d diff_se = Eigen::Matrix4d::Ones();
+    // Iterative process to calculate the true Mean. The rounding error of
+    // the sum grows with N, which matters for float.
+    Vector6 diff_se = Vector6::Ones();
     int max_num = 100;
-    double tol = 1e-5;
+    Scalar tol = std::max(Scalar(1e-5), 10 * N * std::numeric_limits<Scalar>::epsilon());
     int count = 1;
     while (diff_se.norm() >= tol && count <= max_num) {
-        diff_se = Eigen::Matrix4d::Zero();
+        Matrix4 Mean_inv = SE3inv(Mean);
+        diff_se = Vector6::Zero();
         for (int i = 0; i < N; i++) {
-            diff_se += (Mean.inverse() * X[i]).log();
+            diff_se += se3Log(Mean_inv * X[i].template cast<Scalar>());
         }
-        Mean *= ((1.0 / N)* diff_se).exp();
+        Mean *= se3Exp((Scalar(1) / N) * diff_se);
         count++;
     }
 
     // Covariance
+    Matrix4 Mean_inv = SE3inv(Mean);
     for (int i = 0; i < N; i++) {
-        diff_se = (Mean.inverse() * X[i]).log();
-        Eigen::VectorXd diff_vex(6);
-        diff_vex << vex(diff_se.block<3, 3>(0, 0)), diff_se.block<3, 1>(0, 3);
+        Vector6 diff_vex = se3Log(Mean_inv * X[i].template cast<Scalar>());
         Cov += diff_vex * diff_vex.transpose();
     }
     Cov /= N;
 }
 
-#endif
\ No newline at end of file
+template <typename Sequence>
+void meanCovParallel(const Sequence &X,
+                     Eigen::Matrix4d &Mean,
+                     Eigen::Matrix<double, 6, 6> &Cov,
+                     ThreadPool &pool,
+                     int grain_size = 256) {
+
+    typedef Eigen::Matrix<double, 6, 1> Vector6d;
+    typedef Eigen::Matrix<double, 6, 6> Matrix6d;
+
+    int N = X.size();
+
+    // Initial approximation of Mean
+    Vector6d sum_se = parallelSum(pool, N, grain_size, Vector6d::Zero().eval(),
+                                  [&](int begin, int end) {
+                                      Vector6d s = Vector6d::Zero();
+                                      for (int i = begin; i < end; i++) {
+                                          s += se3Log(X[i]);
+                                      }
+                                      return s;
+                                  });
+    Mean = se3Exp((1.0 / N) * sum_se);
+
+    // Iterative process to calculate the true Mean
+    Vector6d diff_se = Vector6d::Ones();
+    int max_num = 100;
+    double tol = 1e-5;
+    int count = 1;
+    while (diff_se.norm() >= tol && count <= max_num) {
+        Eigen::Matrix4d Mean_inv = SE3inv(Mean);
+        diff_se = parallelSum(pool, N, grain_size, Vector6d::Zero().eval(),
+                              [&](int begin, int end) {
+                                  Vector6d s = Vector6d::Zero();
+                                  for (int i = begin; i < end; i++) {
+                                      s += se3Log(Mean_inv * X[i]);
+                                  }
+                                  return s;
+                              });
+        Mean *= se3Exp((1.0 / N) * diff_se);
+        count++;
+    }
+
+    // Covariance
+    Eigen::Matrix4d Mean_inv = SE3inv(Mean);
+    Cov = parallelSum(pool, N, grain_size, Matrix6d::Zero().eval(),
+                      [&](int begin, int end) {
+                          Matrix6d c = Matrix6d::Zero();
+                          for (int i = begin; i < end; i++) {
+                              Vector6d diff_vex = se3Log(Mean_inv * X[i]);
+                              c += diff_vex * diff_vex.transpose();
+                          }
+                          return c;
+                      });
+    Cov /= N;
+}
+
+#endif
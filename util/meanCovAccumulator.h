@@ -0,0 +1,169 @@
+/*
+DESCRIPTION:
+
+The program defines MeanCovAccumulator, an incremental version of meanCov
+for poses that arrive one at a time, e.g. while a calibration session is
+still recording. Instead of recomputing the Karcher mean of the whole
+sample set, it keeps the first and second moments of the samples in the
+tangent space at the current mean estimate.
+
+add() takes the logarithm of the new sample relative to the current
+mean, updates the moments and moves the mean by one step. It then
+re-expresses the moments at the new mean to first order. remove_oldest()
+does the same in reverse for the oldest sample, which gives a sliding
+window. Both cost O(1). remove(X) removes an arbitrary stored sample; it
+has to search and erase from the stored samples, which costs O(N).
+
+snapshot() returns the current mean and covariance. If the accumulator
+was constructed with refine_iters > 0, snapshot() first runs up to that
+many full Karcher iterations over the stored samples. They are
+warm-started from the running mean, so they usually converge in one or
+two passes, and they make the result match meanCov.
+
+Input:
+    add(X), remove(X): X - Matrix dim 4x4
+Output:
+    snapshot(Mean, Cov): Mean - Matrix dim 4x4, Cov - Matrix dim 6x6
+*/
+
+#ifndef MEANCOVACCUMULATOR_H
+#define MEANCOVACCUMULATOR_H
+
+#include <deque>
+#include <algorithm>
+#include <eigen3/Eigen/Dense>
+#include "se3ExpLog.h"
+#include "SE3.h"
+
+class MeanCovAccumulator {
+public:
+    explicit MeanCovAccumulator(int refine_iters = 0,
+                                double tol = 1e-5)
+        : refine_iters_(refine_iters), tol_(tol) {
+        clear();
+    }
+
+    void add(const Eigen::Matrix4d& X) {
+        samples_.push_back(X);
+        if (samples_.size() == 1) {
+            Mean_ = X;
+            Mean_inv_ = SE3inv(X);
+            return;
+        }
+        Eigen::Matrix<double, 6, 1> d = se3Log(Mean_inv_ * X);
+        sum_ += d;
+        sum_sq_ += d * d.transpose();
+        recenter(sum_ / samples_.size());
+    }
+
+    // Removes the oldest stored sample. Returns false if there is none.
+    bool remove_oldest() {
+        if (samples_.empty()) {
+            return false;
+        }
+        Eigen::Matrix4d X = samples_.front();
+        samples_.pop_front();
+        subtract(X);
+        return true;
+    }
+
+    // Removes one stored sample equal to X, searching from the oldest.
+    // Returns false if X was never added.
+    bool remove(const Eigen::Matrix4d& X) {
+        auto it = std::find(samples_.begin(), samples_.end(), X);
+        if (it == samples_.end()) {
+            return false;
+        }
+        samples_.erase(it);
+        subtract(X);
+        return true;
+    }
+
+    void snapshot(Eigen::Matrix4d& Mean,
+                  Eigen::Matrix<double, 6, 6>& Cov) {
+        if (refine_iters_ > 0) {
+            refine(refine_iters_);
+        }
+        Mean = Mean_;
+        int N = samples_.size();
+        if (N == 0) {
+            Cov = Eigen::Matrix<double, 6, 6>::Zero();
+            return;
+        }
+        Eigen::Matrix<double, 6, 1> m = sum_ / N;
+        Cov = sum_sq_ / N - m * m.transpose();
+    }
+
+    // Karcher iterations over the stored samples, starting from the
+    // running mean. Recomputes the moments exactly at the result.
+    void refine(int max_num) {
+        int N = samples_.size();
+        if (N == 0) {
+            return;
+        }
+        Eigen::Matrix<double, 6, 1> diff_se = Eigen::Matrix<double, 6, 1>::Ones();
+        int count = 0;
+        while (diff_se.norm() >= tol_ && count < max_num) {
+            diff_se = Eigen::Matrix<double, 6, 1>::Zero();
+            for (const auto& X : samples_) {
+                diff_se += se3Log(Mean_inv_ * X);
+            }
+            Mean_ *= se3Exp((1.0 / N) * diff_se);
+            Mean_inv_ = SE3inv(Mean_);
+            count++;
+        }
+
+        sum_.setZero();
+        sum_sq_.setZero();
+        for (const auto& X : samples_) {
+            Eigen::Matrix<double, 6, 1> d = se3Log(Mean_inv_ * X);
+            sum_ += d;
+            sum_sq_ += d * d.transpose();
+        }
+    }
+
+    void clear() {
+        samples_.clear();
+        Mean_ = Eigen::Matrix4d::Identity();
+        Mean_inv_ = Eigen::Matrix4d::Identity();
+        sum_.setZero();
+        sum_sq_.setZero();
+    }
+
+    int size() const {
+        return samples_.size();
+    }
+
+private:
+    // Takes a sample that was just dropped from samples_ out of the moments
+    void subtract(const Eigen::Matrix4d& X) {
+        if (samples_.empty()) {
+            clear();
+            return;
+        }
+        Eigen::Matrix<double, 6, 1> d = se3Log(Mean_inv_ * X);
+        sum_ -= d;
+        sum_sq_ -= d * d.transpose();
+        recenter(sum_ / samples_.size());
+    }
+
+    // Move the mean by delta (right perturbation) and shift the moments
+    // to the new base point, d_i -> d_i - delta.
+    void recenter(const Eigen::Matrix<double, 6, 1>& delta) {
+        int N = samples_.size();
+        Mean_ *= se3Exp(delta);
+        Mean_inv_ = SE3inv(Mean_);
+        sum_sq_ += -delta * sum_.transpose() - sum_ * delta.transpose() + N * delta * delta.transpose();
+        sum_ -= N * delta;
+    }
+
+    int refine_iters_;
+    double tol_;
+    std::deque<Eigen::Matrix4d> samples_;
+    Eigen::Matrix4d Mean_;
+    Eigen::Matrix4d Mean_inv_;
+    Eigen::Matrix<double, 6, 1> sum_;
+    Eigen::Matrix<double, 6, 6> sum_sq_;
+};
+
+#endif
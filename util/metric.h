@@ -9,6 +9,14 @@ arrays. The program iterates over all matrices in the third dimension of each
 matrix array and computes the norm of the difference between the two matrix 
 expressions for each matrix. The sum of the norms is divided by the total 
 number of matrices to compute the average norm.
+
+The PoseArray overloads evaluate the same residuals in chunks of samples
+stored as structure of arrays, using only the rotation and translation
+parts, and return either every residual or their mean. The generic
+version accepts any sequence with size() and A[i], e.g. CompactPoses
+or PermutedPoses views.
+The residuals are computed in the scalar type of X, Y and Z (float or
+double); the samples are converted to it on the fly.
 */
 
 #ifndef METRIC_H
@@ -17,26 +25,81 @@ number of matrices to compute the average norm.
 #include <iostream>
 #include <cmath>
 #include <vector>
+#include <algorithm>
 #include <eigen3/Eigen/Dense>
+#include "poseArray.h"
 
-double metric(const std::vector<Eigen::Matrix4d>& A,
-              const std::vector<Eigen::Matrix4d>& B,
-              const std::vector<Eigen::Matrix4d>& C,
-              const Eigen::Matrix4d& X,
-              const Eigen::Matrix4d& Y,
-              const Eigen::Matrix4d& Z) {
-    double diff = 0.0;
+template <typename Sequence, typename Scalar>
+Scalar metric(const Sequence& A,
+              const Sequence& B,
+              const Sequence& C,
+              const Eigen::Matrix<Scalar, 4, 4>& X,
+              const Eigen::Matrix<Scalar, 4, 4>& Y,
+              const Eigen::Matrix<Scalar, 4, 4>& Z) {
+    Scalar diff = 0;
     int N = 0;
 
-    for (size_t i = 0; i < A.size(); ++i) {
-        Eigen::Matrix4d lhs = A[i] * X * B[i];
-        Eigen::Matrix4d rhs = Y * C[i] * Z;
+    for (int i = 0; i < static_cast<int>(A.size()); ++i) {
+        Eigen::Matrix<Scalar, 4, 4> lhs = A[i].template cast<Scalar>() * X * B[i].template cast<Scalar>();
+        Eigen::Matrix<Scalar, 4, 4> rhs = Y * C[i].template cast<Scalar>() * Z;
         diff += (lhs - rhs).norm();
         N++;
     }
 
-    diff /= static_cast<double>(N);
+    diff /= N;
     return diff;
 }
 
-#endif
\ No newline at end of file
+// Residuals ||A_i X B_i - Y C_i Z|| of every sample of PoseArray data.
+// The bottom rows of both sides are equal, so only the rotation and
+// translation parts are compared.
+template <typename Scalar>
+void metric(const PoseArrayT<Scalar>& A,
+            const PoseArrayT<Scalar>& B,
+            const PoseArrayT<Scalar>& C,
+            const Eigen::Matrix<Scalar, 4, 4>& X,
+            const Eigen::Matrix<Scalar, 4, 4>& Y,
+            const Eigen::Matrix<Scalar, 4, 4>& Z,
+            Eigen::Matrix<Scalar, Eigen::Dynamic, 1>& res) {
+    typedef PoseArrayT<Scalar> Poses;
+    typename Poses::ChunkPose A_j, B_j, C_j, XB, lhs, YC, rhs;
+    typename Poses::ChunkArray r;
+    res.resize(A.size());
+
+    for (int j = 0; j < A.chunks(); ++j) {
+        A.load(j, A_j);
+        B.load(j, B_j);
+        C.load(j, C_j);
+
+        chunkProduct(X, B_j, XB);
+        chunkProduct(A_j, XB, lhs);
+        chunkProduct(Y, C_j, YC);
+        chunkProduct(YC, Z, rhs);
+
+        r.setZero();
+        for (int e = 0; e < 9; ++e) {
+            r += (lhs.R[e] - rhs.R[e]).square();
+        }
+        for (int e = 0; e < 3; ++e) {
+            r += (lhs.t[e] - rhs.t[e]).square();
+        }
+
+        int n = std::min(Poses::Chunk, A.size() - Poses::Chunk * j);
+        res.segment(Poses::Chunk * j, n) = r.head(n).sqrt().matrix();
+    }
+}
+
+// Mean residual of PoseArray data, same as metric on the vectors
+template <typename Scalar>
+Scalar metric(const PoseArrayT<Scalar>& A,
+              const PoseArrayT<Scalar>& B,
+              const PoseArrayT<Scalar>& C,
+              const Eigen::Matrix<Scalar, 4, 4>& X,
+              const Eigen::Matrix<Scalar, 4, 4>& Y,
+              const Eigen::Matrix<Scalar, 4, 4>& Z) {
+    Eigen::Matrix<Scalar, Eigen::Dynamic, 1> res;
+    metric(A, B, C, X, Y, Z, res);
+    return res.mean();
+}
+
+#endif
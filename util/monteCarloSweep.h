@@ -0,0 +1,196 @@
+/*
+DESCRIPTION:
+
+The program defines monteCarloSweep, which runs the independent cells
+(trial, rate) of a Monte Carlo simulation on a ThreadPool. Every cell
+is queued as its own task, so idle workers take the next cell as soon
+as they finish one and long cells do not hold back the others.
+
+The cell function receives a SweepCell with its trial and rate indices.
+Its random numbers come from the RngStreams of rng.h, derived from the
+seed, the trial and the rate, so every cell draws the same numbers
+whatever the number of threads or the order in which the cells run.
+trialStream() is shared by all rates of a trial (e.g. the ground
+truth), stream() is private to the cell. Each cell writes only its own
+entries of the result matrices, which therefore need no locks, and
+averages taken after the sweep in a fixed order are bit-identical for
+any pool size.
+
+While the cells run, the calling thread reports the number of finished
+cells and the throughput in experiments per second every
+report_seconds, and once at the end. printSweepProgress prints these
+reports on one console line.
+
+The overload taking a SweepCheckpoint makes the sweep resumable. Its
+cell function returns the results of the cell as a vector of doubles,
+which are appended to the checkpoint file as soon as the cell finishes
+and then handed to restore(), which writes them to the result matrices.
+Cells already in the checkpoint are not run again: their stored values
+go straight to restore(). The seed is the one of the checkpoint.
+
+Input:
+    pool: thread pool running the cells
+    seed: seed of all random streams
+    num_trials, num_rates: size of the grid of cells
+    cell: callable taking a const SweepCell&
+    report: progress callback, nullptr for none
+    checkpoint: file of the finished cells (resumable overload)
+    restore: callable taking a const SweepCell& and the cell values
+Output:
+    whatever cell writes, e.g. err1_mat(rate, trial)
+*/
+
+#ifndef MONTECARLOSWEEP_H
+#define MONTECARLOSWEEP_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include "rng.h"
+#include "sweepCheckpoint.h"
+#include "threadPool.h"
+
+struct SweepCell {
+    uint64_t seed;
+    int trial;
+    int rate;
+
+    // Stream shared by all rates of this trial
+    RngStream trialStream(RngPurpose purpose, uint32_t index = 0) const {
+        return RngStream(seed, trial, rngStreamId(purpose, 0, index));
+    }
+
+    // Stream of this cell only
+    RngStream stream(RngPurpose purpose, uint32_t index = 0) const {
+        return RngStream(seed, trial, rngStreamId(purpose, rate + 1, index));
+    }
+};
+
+struct SweepProgress {
+    int done;
+    int total;
+    double seconds;
+    int resumed = 0; // cells read back from a checkpoint, included in done
+
+    // Experiments per second, not counting the resumed cells
+    double rate() const {
+        return seconds > 0 ? (done - resumed) / seconds : 0.0;
+    }
+};
+
+void printSweepProgress(const SweepProgress &p) {
+    int run = p.done - p.resumed;
+    double eta = run > 0 ? p.seconds * (p.total - p.done) / run : 0.0;
+    std::ostringstream line;
+    line << "\r" << p.done << "/" << p.total << " experiments";
+    if (p.resumed > 0) {
+        line << " (" << p.resumed << " resumed)";
+    }
+    line << ", "
+         << std::fixed << std::setprecision(2) << p.rate() << " exp/s, "
+         << std::setprecision(0) << eta << " s left   ";
+    std::cout << line.str() << std::flush;
+    if (p.done == p.total) {
+        std::cout << std::endl;
+    }
+}
+
+// Run the given cells and report the progress until they are all done
+template <typename Task>
+void runSweepCells(ThreadPool &pool,
+                   const std::vector<SweepCell> &cells,
+                   int total,
+                   int resumed,
+                   Task task,
+                   const std::function<void(const SweepProgress &)> &report,
+                   double report_seconds) {
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+    std::atomic<int> done(resumed);
+
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(cells.size());
+    for (const SweepCell &c : cells) {
+        tasks.push_back(pool.submit([&task, &done, c] {
+            task(c);
+            done.fetch_add(1, std::memory_order_relaxed);
+        }));
+    }
+
+    auto progress = [&] {
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return SweepProgress{done.load(std::memory_order_relaxed), total, seconds, resumed};
+    };
+    std::chrono::duration<double> interval(report_seconds);
+    for (auto &t : tasks) {
+        while (t.wait_for(interval) != std::future_status::ready) {
+            if (report) {
+                report(progress());
+            }
+        }
+    }
+    for (auto &t : tasks) {
+        t.get();
+    }
+    if (report) {
+        report(progress());
+    }
+}
+
+template <typename Cell>
+void monteCarloSweep(ThreadPool &pool,
+                     uint64_t seed,
+                     int num_trials,
+                     int num_rates,
+                     Cell cell,
+                     const std::function<void(const SweepProgress &)> &report = printSweepProgress,
+                     double report_seconds = 1.0) {
+    std::vector<SweepCell> cells;
+    cells.reserve(num_trials * num_rates);
+    for (int n = 0; n < num_trials; ++n) {
+        for (int rk = 0; rk < num_rates; ++rk) {
+            cells.push_back(SweepCell{seed, n, rk});
+        }
+    }
+    runSweepCells(pool, cells, cells.size(), 0, cell, report, report_seconds);
+}
+
+template <typename Cell, typename Restore>
+void monteCarloSweep(ThreadPool &pool,
+                     SweepCheckpoint &checkpoint,
+                     int num_trials,
+                     int num_rates,
+                     Cell cell,
+                     Restore restore,
+                     const std::function<void(const SweepProgress &)> &report = printSweepProgress,
+                     double report_seconds = 1.0) {
+    std::vector<SweepCell> cells;
+    std::vector<double> values;
+    int resumed = 0;
+    for (int n = 0; n < num_trials; ++n) {
+        for (int rk = 0; rk < num_rates; ++rk) {
+            SweepCell c = {checkpoint.seed(), n, rk};
+            if (checkpoint.find(n, rk, values)) {
+                restore(c, values);
+                ++resumed;
+            } else {
+                cells.push_back(c);
+            }
+        }
+    }
+
+    auto task = [&](const SweepCell &c) {
+        std::vector<double> v = cell(c);
+        checkpoint.append(c.trial, c.rate, v);
+        restore(c, v);
+    };
+    runSweepCells(pool, cells, num_trials * num_rates, resumed, task, report, report_seconds);
+}
+
+#endif
@@ -45,6 +45,13 @@ The function first checks that the input arguments meet certain requirements:
     Sigma must be symmetric.
     Sigma must be positive definite.
     N must be a positive intege
+
+MultivariateGaussian does the same for repeated draws from one
+distribution: the checks and the Cholesky factorization are done once
+at construction, it keeps its own RngStream (rng.h), and sample(n, y)
+fills y with n samples, reusing its storage when y already has the right
+size. sample(n, y, rng) draws from the stream of the caller instead.
+mvg(mu, Sigma, N) draws N samples from defaultRngStream().
 */
 
 #ifndef MVG_H
@@ -54,56 +61,93 @@ The function first checks that the input arguments meet certain requirements:
 #include <eigen3/Eigen/Dense>
 #include <eigen3/Eigen/Cholesky>
 #include <random>
+#include "rng.h"
+
+class MultivariateGaussian {
+public:
+    MultivariateGaussian(const Eigen::VectorXd& mu,
+                         const Eigen::MatrixXd& Sigma,
+                         const RngStream& rng)
+        : mu_(mu), rng_(rng) {
+        if (mu.size() != Sigma.rows()) {
+            std::cerr << "Length(mu) must equal size(Sigma,1)." << std::endl;
+            exit(EXIT_FAILURE);
+        }
 
-std::pair<Eigen::VectorXd, Eigen::MatrixXd> mvg(const Eigen::VectorXd& mu,
-                                                const Eigen::MatrixXd& Sigma,
-                                                int N) {
-    if (mu.size() != Sigma.rows()) {
-        std::cerr << "Length(mu) must equal size(Sigma,1)." << std::endl;
-        exit(EXIT_FAILURE);
-    }
+        if (Sigma.rows() != Sigma.cols()) {
+            std::cerr << "Sigma must be square." << std::endl;
+            exit(EXIT_FAILURE);
+        }
 
-    if (Sigma.rows() != Sigma.cols()) {
-        std::cerr << "Sigma must be square." << std::endl;
-        exit(EXIT_FAILURE);
-    }
+        if ((Sigma - Sigma.transpose()).norm() > 1e-15) {
+            std::cerr << "Sigma must be symmetric." << std::endl;
+            exit(EXIT_FAILURE);
+        }
 
-    if ((Sigma - Sigma.transpose()).norm() > 1e-15) {
-        std::cerr << "Sigma must be symmetric." << std::endl;
-        exit(EXIT_FAILURE);
+        Eigen::LLT<Eigen::MatrixXd> llt(Sigma);
+        if (llt.info() != Eigen::Success) {
+            std::cerr << "Sigma must be positive definite." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        L_ = llt.matrixL();
     }
 
-    bool is_spd;
-    Eigen::MatrixXd L = Sigma.llt().matrixL();
-    is_spd = ((L * L.transpose() - Sigma).norm() < 1e-8);
+    MultivariateGaussian(const Eigen::VectorXd& mu,
+                         const Eigen::MatrixXd& Sigma,
+                         uint64_t seed = std::random_device()())
+        : MultivariateGaussian(mu, Sigma, RngStream(seed)) {}
 
-    if (!is_spd) {
-        std::cerr << "Sigma must be positive definite." << std::endl;
-        exit(EXIT_FAILURE);
+    int dim() const {
+        return mu_.size();
     }
 
-    if (N < 1) {
-        std::cerr << "A positive integer number of samples must be requested." << std::endl;
-        exit(EXIT_FAILURE);
+    // Lower triangular Cholesky factor of Sigma
+    const Eigen::MatrixXd& factor() const {
+        return L_;
     }
 
-    int m = mu.size();
-    Eigen::MatrixXd y(m, N);
-    Eigen::MatrixXd R = L;
+    void seed(uint64_t s) {
+        rng_ = RngStream(s);
+    }
 
-    std::random_device rd;
-    std::default_random_engine generator(rd());
-    std::normal_distribution<double> distribution(0.0, 1.0);
+    // Fill y (dim x n) with n samples, one per column
+    void sample(int n, Eigen::MatrixXd& y) {
+        sample(n, y, rng_);
+    }
 
-    for (int i = 0; i < N; i++) {
-        Eigen::VectorXd r(m);
-        for (int j = 0; j < m; j++) {
-            r(j) = distribution(generator);
+    void sample(int n, Eigen::MatrixXd& y, RngStream& rng) {
+        if (n < 1) {
+            std::cerr << "A positive integer number of samples must be requested." << std::endl;
+            exit(EXIT_FAILURE);
         }
-        y.col(i) = L * r + mu;
+
+        r_.resize(dim(), n);
+        fillNormal(r_, rng);
+        y.resize(dim(), n);
+        y.noalias() = L_.triangularView<Eigen::Lower>() * r_;
+        y.colwise() += mu_;
+    }
+
+    Eigen::MatrixXd sample(int n) {
+        Eigen::MatrixXd y;
+        sample(n, y);
+        return y;
     }
 
-    return {y, R};
+private:
+    Eigen::VectorXd mu_;
+    Eigen::MatrixXd L_;
+    Eigen::MatrixXd r_;
+    RngStream rng_;
+};
+
+std::pair<Eigen::VectorXd, Eigen::MatrixXd> mvg(const Eigen::VectorXd& mu,
+                                                const Eigen::MatrixXd& Sigma,
+                                                int N) {
+    MultivariateGaussian gaussian(mu, Sigma, defaultRngStream());
+    Eigen::MatrixXd y;
+    gaussian.sample(N, y, defaultRngStream());
+    return {y, gaussian.factor()};
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,72 @@
+/*
+DESCRIPTION:
+
+The program defines PermutedPoses, a reordered view of a sequence of
+poses: X[i] of the view is X[index[i]] of the underlying sequence. Only
+the index array is stored, so scrambling a data set or taking a subset
+of it copies no pose. The view holds a pointer to the sequence, which
+must outlive it.
+
+PermutedPoses has size() and X[i] like the sequences it wraps, so it can
+be passed to meanCov, PoseStats, PoseArray, metric, batchSolveXY, the
+axbyczProb solvers and axbyczMultiStart. These take all their data
+sequences in the same type; data sets that are not permuted are wrapped
+with the identity permutation.
+
+Input:
+    X: sequence of poses, e.g. a vector of Matrix4d or CompactPoses
+    index: positions in X, defaults to 0, 1, ..., X.size() - 1
+Output:
+    X[i]: X[index[i]], a reference to the stored pose for vectors
+*/
+
+#ifndef PERMUTEDPOSES_H
+#define PERMUTEDPOSES_H
+
+#include <numeric>
+#include <utility>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+
+template <typename Sequence = std::vector<Eigen::Matrix4d>>
+class PermutedPoses {
+public:
+    // Identity permutation of X
+    explicit PermutedPoses(const Sequence &X) : X_(&X), index_(X.size()) {
+        std::iota(index_.begin(), index_.end(), 0);
+    }
+
+    PermutedPoses(const Sequence &X, std::vector<int> index)
+        : X_(&X), index_(std::move(index)) {}
+
+    int size() const {
+        return index_.size();
+    }
+
+    auto operator[](int i) const -> decltype(std::declval<const Sequence &>()[0]) {
+        return (*X_)[index_[i]];
+    }
+
+    const std::vector<int> &indices() const {
+        return index_;
+    }
+
+    const Sequence &base() const {
+        return *X_;
+    }
+
+    // Copy of the viewed poses, in the order of the view
+    std::vector<Eigen::Matrix4d> toMatrices() const {
+        std::vector<Eigen::Matrix4d> X(size());
+        for (int i = 0; i < size(); ++i) {
+            X[i] = (*this)[i];
+        }
+        return X;
+    }
+
+private:
+    const Sequence *X_;
+    std::vector<int> index_;
+};
+
+#endif
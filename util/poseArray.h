@@ -0,0 +1,139 @@
+/*
+DESCRIPTION:
+
+The program defines PoseArray, a sequence of rigid transformations in a
+structure-of-arrays layout, and the chunk operations the batched
+residual kernels (rotError, tranError and metric on PoseArray inputs)
+are built from.
+
+Each of the 9 rotation entries and 3 translation entries is stored for
+all samples next to each other, in two separate aligned arrays of
+rotations and translations. The constant bottom row is not stored. The
+kernels work on chunks of PoseArray::Chunk samples held in fixed-size
+Eigen arrays, so every product of two poses is 3x3 rotation and
+translation arithmetic over whole chunks. Eigen vectorizes these with
+the widest instruction set the compiler targets (SSE, AVX2 or AVX-512)
+and falls back to scalar code otherwise. The storage is padded with
+identity poses to a whole number of chunks.
+
+PoseArray stores doubles. PoseArrayf stores floats, which puts twice as
+many samples in every SIMD register and halves the memory traffic; the
+poses are converted when the array is built.
+
+Input:
+    X: vector of Matrices dim 4x4
+*/
+
+#ifndef POSEARRAY_H
+#define POSEARRAY_H
+
+#include <vector>
+#include <eigen3/Eigen/Dense>
+
+// Poses of one chunk of samples, rotation entries in column-major order
+template <typename Scalar>
+struct PoseChunk {
+    static constexpr int Size = 32;
+    typedef Eigen::Array<Scalar, Size, 1> Array;
+
+    Array R[9];
+    Array t[3];
+};
+
+template <typename Scalar>
+class PoseArrayT {
+public:
+    static constexpr int Chunk = PoseChunk<Scalar>::Size;
+    typedef typename PoseChunk<Scalar>::Array ChunkArray;
+    typedef PoseChunk<Scalar> ChunkPose;
+
+    PoseArrayT() : N_(0), padded_(0) {}
+
+    // Any sequence with size() and X[i], e.g. a vector of Matrix4d or CompactPoses
+    template <typename Sequence>
+    explicit PoseArrayT(const Sequence &X)
+        : N_(X.size()),
+          padded_((N_ + Chunk - 1) / Chunk * Chunk),
+          R_(9 * padded_, Scalar(0)),
+          t_(3 * padded_, Scalar(0)) {
+        for (int e = 0; e < 9; e += 4) {
+            std::fill_n(&R_[e * padded_], padded_, Scalar(1));
+        }
+        for (int i = 0; i < N_; ++i) {
+            Eigen::Matrix<Scalar, 4, 4> X_i = X[i].template cast<Scalar>();
+            for (int c = 0; c < 3; ++c) {
+                for (int r = 0; r < 3; ++r) {
+                    R_[(3 * c + r) * padded_ + i] = X_i(r, c);
+                }
+                t_[c * padded_ + i] = X_i(c, 3);
+            }
+        }
+    }
+
+    int size() const {
+        return N_;
+    }
+
+    int chunks() const {
+        return padded_ / Chunk;
+    }
+
+    // Samples [Chunk * j, Chunk * (j + 1)) of the array
+    void load(int j, ChunkPose &P) const {
+        for (int e = 0; e < 9; ++e) {
+            P.R[e] = Eigen::Map<const ChunkArray>(&R_[e * padded_ + Chunk * j]);
+        }
+        for (int e = 0; e < 3; ++e) {
+            P.t[e] = Eigen::Map<const ChunkArray>(&t_[e * padded_ + Chunk * j]);
+        }
+    }
+
+private:
+    int N_, padded_;
+    std::vector<Scalar, Eigen::aligned_allocator<Scalar>> R_;
+    std::vector<Scalar, Eigen::aligned_allocator<Scalar>> t_;
+};
+
+typedef PoseArrayT<double> PoseArray;
+typedef PoseArrayT<float> PoseArrayf;
+
+// Out = M * P for a single pose M
+template <typename Scalar>
+inline void chunkProduct(const Eigen::Matrix<Scalar, 4, 4> &M,
+                         const PoseChunk<Scalar> &P,
+                         PoseChunk<Scalar> &Out) {
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            Out.R[3 * c + r] = M(r, 0) * P.R[3 * c] + M(r, 1) * P.R[3 * c + 1] + M(r, 2) * P.R[3 * c + 2];
+        }
+        Out.t[r] = M(r, 0) * P.t[0] + M(r, 1) * P.t[1] + M(r, 2) * P.t[2] + M(r, 3);
+    }
+}
+
+// Out = P * M for a single pose M
+template <typename Scalar>
+inline void chunkProduct(const PoseChunk<Scalar> &P,
+                         const Eigen::Matrix<Scalar, 4, 4> &M,
+                         PoseChunk<Scalar> &Out) {
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            Out.R[3 * c + r] = P.R[r] * M(0, c) + P.R[3 + r] * M(1, c) + P.R[6 + r] * M(2, c);
+        }
+        Out.t[r] = P.R[r] * M(0, 3) + P.R[3 + r] * M(1, 3) + P.R[6 + r] * M(2, 3) + P.t[r];
+    }
+}
+
+// Out = P * Q sample by sample
+template <typename Scalar>
+inline void chunkProduct(const PoseChunk<Scalar> &P,
+                         const PoseChunk<Scalar> &Q,
+                         PoseChunk<Scalar> &Out) {
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            Out.R[3 * c + r] = P.R[r] * Q.R[3 * c] + P.R[3 + r] * Q.R[3 * c + 1] + P.R[6 + r] * Q.R[3 * c + 2];
+        }
+        Out.t[r] = P.R[r] * Q.t[0] + P.R[3 + r] * Q.t[1] + P.R[6 + r] * Q.t[2] + P.t[r];
+    }
+}
+
+#endif
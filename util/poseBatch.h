@@ -0,0 +1,274 @@
+/*
+DESCRIPTION:
+
+The program defines PoseBatch, the poses of K independent datasets in a
+structure-of-arrays layout, and meanCov for all K datasets at once.
+
+Every rotation entry and every translation entry of sample i is stored
+for the K datasets next to each other, in two separate aligned arrays
+of rotations and translations. The loops over the samples then work on
+K contiguous values at a time, so the products, the closed-form
+logarithm of se3ExpLog.h and the sums vectorize across the datasets
+(atan2 is evaluated lane by lane). Datasets may hold different numbers
+of samples; the unused slots hold the identity and are masked out.
+
+meanCov computes the same bi-invariant mean and covariance as the
+single-dataset meanCov for each dataset, with the same tolerance and
+iteration limit per dataset. Relative rotations with an angle close to
+pi are rare and are handed to the scalar se3Log.
+
+Input:
+    X: K vectors of Matrices dim 4x4
+Output:
+    Mean: K Matrices dim 4x4
+    Cov: K Matrices dim 6x6
+*/
+
+#ifndef POSEBATCH_H
+#define POSEBATCH_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+#include "se3ExpLog.h"
+#include "SE3.h"
+
+// Rows of K lanes, one value per dataset, stored contiguously
+typedef Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> LaneArray;
+
+class PoseBatch {
+public:
+    // K datasets of up to N samples each
+    PoseBatch(int K, int N)
+        : K_(K), N_(N), sizes_(K, 0), R_(9 * N * K, 0.0), t_(3 * N * K, 0.0) {
+        for (int i = 0; i < N; ++i) {
+            for (int c = 0; c < 9; c += 4) {
+                std::fill_n(&R_[(9 * i + c) * K], K, 1.0);
+            }
+        }
+    }
+
+    explicit PoseBatch(const std::vector<std::vector<Eigen::Matrix4d>> &X)
+        : PoseBatch(X.size(), maxSize(X)) {
+        for (int k = 0; k < K_; ++k) {
+            set(k, X[k]);
+        }
+    }
+
+    // Store X as dataset k, X.size() must not exceed capacity()
+    void set(int k, const std::vector<Eigen::Matrix4d> &X) {
+        sizes_[k] = X.size();
+        for (int i = 0; i < sizes_[k]; ++i) {
+            for (int c = 0; c < 3; ++c) {
+                for (int r = 0; r < 3; ++r) {
+                    R_[(9 * i + 3 * c + r) * K_ + k] = X[i](r, c);
+                }
+                t_[(3 * i + c) * K_ + k] = X[i](c, 3);
+            }
+        }
+    }
+
+    Eigen::Matrix4d pose(int k, int i) const {
+        Eigen::Matrix4d X = Eigen::Matrix4d::Identity();
+        for (int c = 0; c < 3; ++c) {
+            for (int r = 0; r < 3; ++r) {
+                X(r, c) = R_[(9 * i + 3 * c + r) * K_ + k];
+            }
+            X(c, 3) = t_[(3 * i + c) * K_ + k];
+        }
+        return X;
+    }
+
+    int datasets() const {
+        return K_;
+    }
+
+    int capacity() const {
+        return N_;
+    }
+
+    int size(int k) const {
+        return sizes_[k];
+    }
+
+    // Entry (r, c) of the rotations of sample i, one per dataset
+    const double *R(int i, int r, int c) const {
+        return &R_[(9 * i + 3 * c + r) * K_];
+    }
+
+    // Entry r of the translations of sample i, one per dataset
+    const double *t(int i, int r) const {
+        return &t_[(3 * i + r) * K_];
+    }
+
+private:
+    static int maxSize(const std::vector<std::vector<Eigen::Matrix4d>> &X) {
+        int N = 0;
+        for (const auto &x : X) {
+            N = std::max(N, static_cast<int>(x.size()));
+        }
+        return N;
+    }
+
+    int K_, N_;
+    std::vector<int> sizes_;
+    std::vector<double, Eigen::aligned_allocator<double>> R_;
+    std::vector<double, Eigen::aligned_allocator<double>> t_;
+};
+
+// Accumulate se3Log(M_k^{-1} X_ik) over the samples of every dataset k,
+// where Minv holds M_k^{-1} as 12 rows of K lanes (9 rotation entries in
+// column-major order, then the translation). With Cov set, the outer
+// products are accumulated in its 21 upper triangular rows instead.
+void accumulateBatchLog(const PoseBatch &X,
+                        const LaneArray &Minv,
+                        LaneArray &sum,
+                        LaneArray *Cov = nullptr) {
+    typedef Eigen::ArrayXd Lanes;
+    typedef Eigen::Map<const Lanes> LaneMap;
+
+    int K = X.datasets();
+    int N = X.capacity();
+    LaneArray P(12, K), xi(6, K);
+    Lanes s0(K), s1(K), s2(K), sin_theta(K), cos_theta(K), theta(K), half(K), f(K), D(K), mask(K);
+    Lanes w0(K), w1(K), w2(K), t0(K), t1(K), t2(K), c0(K), c1(K), c2(K);
+
+    sum.setZero(6, K);
+    if (Cov) {
+        Cov->setZero(21, K);
+    }
+
+    for (int i = 0; i < N; ++i) {
+        // P = M^{-1} X_i
+        for (int c = 0; c < 3; ++c) {
+            for (int r = 0; r < 3; ++r) {
+                P.row(3 * c + r) = Minv.row(r) * LaneMap(X.R(i, 0, c), K).transpose()
+                                 + Minv.row(3 + r) * LaneMap(X.R(i, 1, c), K).transpose()
+                                 + Minv.row(6 + r) * LaneMap(X.R(i, 2, c), K).transpose();
+            }
+        }
+        for (int r = 0; r < 3; ++r) {
+            P.row(9 + r) = Minv.row(r) * LaneMap(X.t(i, 0), K).transpose()
+                         + Minv.row(3 + r) * LaneMap(X.t(i, 1), K).transpose()
+                         + Minv.row(6 + r) * LaneMap(X.t(i, 2), K).transpose()
+                         + Minv.row(9 + r);
+        }
+
+        // Rotational part, as in so3Log
+        s0 = P.row(5) - P.row(7);
+        s1 = P.row(6) - P.row(2);
+        s2 = P.row(1) - P.row(3);
+        cos_theta = 0.5 * (P.row(0) + P.row(4) + P.row(8) - 1.0).transpose();
+        sin_theta = 0.5 * (s0.square() + s1.square() + s2.square()).sqrt();
+        for (int k = 0; k < K; ++k) {
+            theta[k] = std::atan2(sin_theta[k], cos_theta[k]);
+        }
+        f = (theta < 1e-4).select(0.5 + theta.square() / 12.0, theta / (2.0 * theta.sin()));
+        xi.row(0) = (f * s0).transpose();
+        xi.row(1) = (f * s1).transpose();
+        xi.row(2) = (f * s2).transpose();
+
+        // Translational part, V^{-1} t = t - w x t / 2 + D * w x (w x t)
+        half = 0.5 * theta;
+        D = (theta < 1e-4).select(1.0 / 12.0 + theta.square() / 720.0,
+                                   (1.0 - half * half.cos() / half.sin()) / theta.square());
+        w0 = xi.row(0).transpose();
+        w1 = xi.row(1).transpose();
+        w2 = xi.row(2).transpose();
+        t0 = P.row(9).transpose();
+        t1 = P.row(10).transpose();
+        t2 = P.row(11).transpose();
+        c0 = w1 * t2 - w2 * t1;
+        c1 = w2 * t0 - w0 * t2;
+        c2 = w0 * t1 - w1 * t0;
+        xi.row(3) = (t0 - 0.5 * c0 + D * (w1 * c2 - w2 * c1)).transpose();
+        xi.row(4) = (t1 - 0.5 * c1 + D * (w2 * c0 - w0 * c2)).transpose();
+        xi.row(5) = (t2 - 0.5 * c2 + D * (w0 * c1 - w1 * c0)).transpose();
+
+        // Angles close to pi and unused slots
+        for (int k = 0; k < K; ++k) {
+            mask[k] = i < X.size(k) ? 1.0 : 0.0;
+            if (mask[k] > 0 && cos_theta[k] < -0.99) {
+                Eigen::Matrix4d P_k = Eigen::Matrix4d::Identity();
+                for (int c = 0; c < 3; ++c) {
+                    for (int r = 0; r < 3; ++r) {
+                        P_k(r, c) = P(3 * c + r, k);
+                    }
+                    P_k(c, 3) = P(9 + c, k);
+                }
+                xi.col(k) = se3Log(P_k);
+            }
+        }
+        xi.rowwise() *= mask.transpose();
+
+        sum += xi;
+        if (Cov) {
+            for (int a = 0, row = 0; a < 6; ++a) {
+                for (int b = a; b < 6; ++b, ++row) {
+                    Cov->row(row) += xi.row(a) * xi.row(b);
+                }
+            }
+        }
+    }
+}
+
+// Store the inverse of each of the K poses as 12 rows of K lanes
+void batchInverseLanes(const std::vector<Eigen::Matrix4d> &M, LaneArray &Minv) {
+    Minv.resize(12, M.size());
+    for (size_t k = 0; k < M.size(); ++k) {
+        Eigen::Matrix4d M_inv = SE3inv(M[k]);
+        for (int c = 0; c < 3; ++c) {
+            Minv.col(k).segment<3>(3 * c) = M_inv.block<3, 1>(0, c).array();
+        }
+        Minv.col(k).tail<3>() = M_inv.block<3, 1>(0, 3).array();
+    }
+}
+
+void meanCov(const PoseBatch &X,
+             std::vector<Eigen::Matrix4d> &Mean,
+             std::vector<Eigen::Matrix<double, 6, 6>> &Cov) {
+
+    int K = X.datasets();
+    Mean.assign(K, Eigen::Matrix4d::Identity());
+    Cov.assign(K, Eigen::Matrix<double, 6, 6>::Zero());
+
+    LaneArray Minv, sum, CovLanes;
+
+    // Initial approximation of Mean
+    batchInverseLanes(Mean, Minv);
+    accumulateBatchLog(X, Minv, sum);
+    for (int k = 0; k < K; ++k) {
+        Mean[k] = se3Exp((1.0 / X.size(k)) * sum.col(k).matrix());
+    }
+
+    // Iterative process to calculate the true Mean, until every dataset
+    // has converged. Converged datasets keep their Mean.
+    int max_num = 100;
+    double tol = 1e-5;
+    std::vector<bool> active(K, true);
+    for (int count = 1; count <= max_num && std::count(active.begin(), active.end(), true) > 0; ++count) {
+        batchInverseLanes(Mean, Minv);
+        accumulateBatchLog(X, Minv, sum);
+        for (int k = 0; k < K; ++k) {
+            if (active[k]) {
+                Eigen::Matrix<double, 6, 1> diff_se = sum.col(k).matrix();
+                Mean[k] *= se3Exp((1.0 / X.size(k)) * diff_se);
+                active[k] = diff_se.norm() >= tol;
+            }
+        }
+    }
+
+    // Covariance
+    batchInverseLanes(Mean, Minv);
+    accumulateBatchLog(X, Minv, sum, &CovLanes);
+    for (int k = 0; k < K; ++k) {
+        for (int a = 0, row = 0; a < 6; ++a) {
+            for (int b = a; b < 6; ++b, ++row) {
+                Cov[k](a, b) = Cov[k](b, a) = CovLanes(row, k) / X.size(k);
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,102 @@
+/*
+DESCRIPTION:
+
+The program defines PoseStats, the mean and covariance of one sequence
+of rigid transformations, computed once with meanCov and then shared by
+every solver that needs them.
+
+The solvers often also need the statistics of the inverted sequence.
+For the bi-invariant mean these follow from the original ones without
+touching the data again: if X_i = M exp(xi_i), then
+X_i^{-1} = M^{-1} exp(-Ad_M xi_i). The mean of the inverses is therefore
+M^{-1} and their covariance is Ad_M * Cov * Ad_M^T. meanInv() and
+covInv() compute these on first use and cache them, and inverse()
+returns them as a PoseStats of their own.
+
+PoseStats holds double statistics and PoseStatsf float ones; both can be
+computed from double or float data.
+
+Input:
+    X: vector of Matrices dim 4x4, or Mean - Matrix dim 4x4 and
+       Cov - Matrix dim 6x6
+Output:
+    mean(), meanInv(): Matrix dim 4x4
+    cov(), covInv(): Matrix dim 6x6
+*/
+
+#ifndef POSESTATS_H
+#define POSESTATS_H
+
+#include <vector>
+#include <eigen3/Eigen/Dense>
+#include "meanCov.h"
+#include "SE3.h"
+
+template <typename Scalar>
+class PoseStatsT {
+public:
+    typedef Eigen::Matrix<Scalar, 4, 4> Matrix4;
+    typedef Eigen::Matrix<Scalar, 6, 6> Matrix6;
+
+    PoseStatsT()
+        : Mean_(Matrix4::Identity()),
+          Cov_(Matrix6::Zero()),
+          has_inv_(false) {}
+
+    // Any sequence meanCov accepts, e.g. a vector of Matrix4d or CompactPoses
+    template <typename Sequence>
+    explicit PoseStatsT(const Sequence& X)
+        : has_inv_(false) {
+        meanCov(X, Mean_, Cov_);
+    }
+
+    PoseStatsT(const Matrix4& Mean,
+               const Matrix6& Cov)
+        : Mean_(Mean), Cov_(Cov), has_inv_(false) {}
+
+    const Matrix4& mean() const {
+        return Mean_;
+    }
+
+    const Matrix6& cov() const {
+        return Cov_;
+    }
+
+    // Mean of the inverted sequence
+    const Matrix4& meanInv() const {
+        computeInverse();
+        return Mean_inv_;
+    }
+
+    // Covariance of the inverted sequence
+    const Matrix6& covInv() const {
+        computeInverse();
+        return Cov_inv_;
+    }
+
+    PoseStatsT inverse() const {
+        return PoseStatsT(meanInv(), covInv());
+    }
+
+private:
+    void computeInverse() const {
+        if (has_inv_) {
+            return;
+        }
+        Matrix6 Ad = SE3Ad(Mean_);
+        Mean_inv_ = SE3inv(Mean_);
+        Cov_inv_ = Ad * Cov_ * Ad.transpose();
+        has_inv_ = true;
+    }
+
+    Matrix4 Mean_;
+    Matrix6 Cov_;
+    mutable Matrix4 Mean_inv_;
+    mutable Matrix6 Cov_inv_;
+    mutable bool has_inv_;
+};
+
+typedef PoseStatsT<double> PoseStats;
+typedef PoseStatsT<float> PoseStatsf;
+
+#endif
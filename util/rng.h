@@ -0,0 +1,160 @@
+/*
+DESCRIPTION:
+
+The program defines the random number service shared by the data
+generation functions (generateABC, MultivariateGaussian, scrambleData,
+initializeXYZ, sensorNoise).
+
+RngStream is a counter-based generator, Philox4x32-10 (Salmon et al.,
+"Parallel random numbers: as easy as 1, 2, 3", SC 2011). Block k of a
+stream is the Philox bijection of the counter (k, trial, stream) under
+the key seed, so a stream is fully determined by (seed, trial, stream)
+and streams with different ids never overlap. Each Monte Carlo trial,
+scramble rate or data set draws from its own stream, and results do not
+depend on the order in which the streams are used or on the thread that
+uses them.
+
+rngStreamId packs the purpose of a stream with up to two indices, e.g.
+the scramble rate and the data set. The normal and uniform draws are
+computed here rather than with the <random> distributions, whose output
+differs between standard libraries.
+
+defaultRngStream() is a per-thread stream seeded from std::random_device,
+used by the overloads that take no stream. Its output is not
+reproducible.
+
+Input:
+    seed: 64 bit seed of the simulation
+    trial: index of the Monte Carlo trial
+    stream: id of the stream within the trial, see rngStreamId
+Output:
+    32 bit integers, uniform doubles in [0, 1), standard normal doubles
+*/
+
+#ifndef RNG_H
+#define RNG_H
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <eigen3/Eigen/Core>
+
+// Philox4x32-10 block function
+inline std::array<uint32_t, 4> philox4x32(std::array<uint32_t, 4> ctr,
+                                          std::array<uint32_t, 2> key) {
+    const uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+    const uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+
+    for (int round = 0; round < 10; ++round) {
+        uint64_t p0 = static_cast<uint64_t>(M0) * ctr[0];
+        uint64_t p1 = static_cast<uint64_t>(M1) * ctr[2];
+        ctr = {static_cast<uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0], static_cast<uint32_t>(p1),
+               static_cast<uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1], static_cast<uint32_t>(p0)};
+        key[0] += W0;
+        key[1] += W1;
+    }
+    return ctr;
+}
+
+enum class RngPurpose : uint32_t {
+    GroundTruth = 1,
+    Data,
+    Scramble,
+    SensorNoise
+};
+
+// Stream id of a purpose and two indices below 4096
+inline uint32_t rngStreamId(RngPurpose purpose, uint32_t a = 0, uint32_t b = 0) {
+    return (static_cast<uint32_t>(purpose) << 24) | ((a & 0xFFF) << 12) | (b & 0xFFF);
+}
+
+class RngStream {
+public:
+    typedef uint32_t result_type;
+
+    explicit RngStream(uint64_t seed, uint32_t trial = 0, uint32_t stream = 0)
+        : key_{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)},
+          trial_(trial), stream_(stream) {}
+
+    static constexpr result_type min() {
+        return 0;
+    }
+
+    static constexpr result_type max() {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    result_type operator()() {
+        if (used_ == 4) {
+            block_ = philox4x32({static_cast<uint32_t>(counter_), static_cast<uint32_t>(counter_ >> 32),
+                                 trial_, stream_}, key_);
+            ++counter_;
+            used_ = 0;
+        }
+        return block_[used_++];
+    }
+
+    // Uniform in [0, 1) with 53 random bits
+    double uniform() {
+        uint64_t hi = (*this)();
+        uint64_t lo = (*this)();
+        return static_cast<double>(((hi << 32) | lo) >> 11) * 0x1.0p-53;
+    }
+
+    // Uniform integer in [0, n), by multiply and shift
+    int uniformInt(int n) {
+        return static_cast<int>((static_cast<uint64_t>((*this)()) * static_cast<uint64_t>(n)) >> 32);
+    }
+
+    // Standard normal, by the Box-Muller transform. The second value of
+    // each pair is kept for the next call.
+    double normal() {
+        if (has_normal_) {
+            has_normal_ = false;
+            return next_normal_;
+        }
+        double r = std::sqrt(-2.0 * std::log(1.0 - uniform()));
+        double phi = 2.0 * M_PI * uniform();
+        next_normal_ = r * std::sin(phi);
+        has_normal_ = true;
+        return r * std::cos(phi);
+    }
+
+private:
+    std::array<uint32_t, 2> key_;
+    uint32_t trial_, stream_;
+    uint64_t counter_ = 0;
+    std::array<uint32_t, 4> block_ = {};
+    int used_ = 4;
+    bool has_normal_ = false;
+    double next_normal_ = 0;
+};
+
+// Fill x with values uniform in [-1, 1), the range of Eigen's Random()
+template <typename Derived>
+void fillUniform(Eigen::MatrixBase<Derived>& x, RngStream& rng) {
+    for (Eigen::Index j = 0; j < x.cols(); ++j) {
+        for (Eigen::Index i = 0; i < x.rows(); ++i) {
+            x(i, j) = 2.0 * rng.uniform() - 1.0;
+        }
+    }
+}
+
+// Fill x with standard normal values
+template <typename Derived>
+void fillNormal(Eigen::MatrixBase<Derived>& x, RngStream& rng) {
+    for (Eigen::Index j = 0; j < x.cols(); ++j) {
+        for (Eigen::Index i = 0; i < x.rows(); ++i) {
+            x(i, j) = rng.normal();
+        }
+    }
+}
+
+inline RngStream& defaultRngStream() {
+    thread_local RngStream rng((static_cast<uint64_t>(std::random_device()()) << 32) | std::random_device()());
+    return rng;
+}
+
+#endif
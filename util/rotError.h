@@ -13,6 +13,11 @@ it computes the angle-axis representation of R12 using the
 Eigen::AngleAxisd class and returns the angle component of 
 the resulting object.
 
+The PoseArray overloads compute the errors of many pairs at once in
+chunks, from the trace and the skew-symmetric part of R1^T R2, and
+return either every error or their mean. All versions work in the
+scalar type of their inputs (float or double).
+
 The Eigen::AngleAxisd class represents a rotation as an angle 
 of rotation about a given axis in 3D space. Therefore, the 
 rotError function returns the angle component of the rotation 
@@ -23,18 +28,71 @@ between the two matrices in radians.
 #define ROTERROR_H
 
 #include <iostream>
+#include <cmath>
 #include "so3Vec.h"
 #include "skewLog.h"
+#include "poseArray.h"
 
-double rotError(const Eigen::Matrix4d& X1,
-                const Eigen::Matrix4d& X2) {
-    Eigen::Matrix3d R1 = X1.block<3, 3>(0, 0);
-    Eigen::Matrix3d R2 = X2.block<3, 3>(0, 0);
-    Eigen::Matrix3d R12 = R1.transpose() * R2;
+template <typename Derived1, typename Derived2>
+typename Derived1::Scalar rotError(const Eigen::MatrixBase<Derived1>& X1,
+                                   const Eigen::MatrixBase<Derived2>& X2) {
+    typedef typename Derived1::Scalar Scalar;
+    Eigen::Matrix<Scalar, 3, 3> R1 = X1.template block<3, 3>(0, 0);
+    Eigen::Matrix<Scalar, 3, 3> R2 = X2.template block<3, 3>(0, 0);
+    Eigen::Matrix<Scalar, 3, 3> R12 = R1.transpose() * R2;
 
-    Eigen::Vector3d err_vec = so3Vec(skewLog(R12));
+    Eigen::Matrix<Scalar, 3, 1> err_vec = so3Vec(skewLog(R12));
 
     return err_vec.norm();
 }
 
-#endif
\ No newline at end of file
+// Rotation errors of a chunk of pairs, from the trace and the skew part of
+// R1^T R2 as in so3Log
+template <typename Scalar>
+inline void rotError(const PoseChunk<Scalar> &X1,
+                     const PoseChunk<Scalar> &X2,
+                     typename PoseChunk<Scalar>::Array &err) {
+    typedef typename PoseChunk<Scalar>::Array ChunkArray;
+    ChunkArray M[9];
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            M[3 * c + r] = X1.R[3 * r] * X2.R[3 * c] + X1.R[3 * r + 1] * X2.R[3 * c + 1]
+                         + X1.R[3 * r + 2] * X2.R[3 * c + 2];
+        }
+    }
+    ChunkArray cos_theta = Scalar(0.5) * (M[0] + M[4] + M[8] - Scalar(1));
+    ChunkArray sin_theta = Scalar(0.5) * ((M[5] - M[7]).square() + (M[6] - M[2]).square()
+                                          + (M[1] - M[3]).square()).sqrt();
+    for (int i = 0; i < PoseChunk<Scalar>::Size; ++i) {
+        err[i] = std::atan2(sin_theta[i], cos_theta[i]);
+    }
+}
+
+// Rotation error of every pair X1[i], X2[i]
+template <typename Scalar>
+void rotError(const PoseArrayT<Scalar> &X1,
+              const PoseArrayT<Scalar> &X2,
+              Eigen::Matrix<Scalar, Eigen::Dynamic, 1> &err) {
+    typedef PoseArrayT<Scalar> Poses;
+    typename Poses::ChunkPose P, Q;
+    typename Poses::ChunkArray e;
+    err.resize(X1.size());
+    for (int j = 0; j < X1.chunks(); ++j) {
+        X1.load(j, P);
+        X2.load(j, Q);
+        rotError(P, Q, e);
+        int n = std::min(Poses::Chunk, X1.size() - Poses::Chunk * j);
+        err.segment(Poses::Chunk * j, n) = e.head(n).matrix();
+    }
+}
+
+// Mean rotation error over all pairs
+template <typename Scalar>
+Scalar rotError(const PoseArrayT<Scalar> &X1,
+                const PoseArrayT<Scalar> &X2) {
+    Eigen::Matrix<Scalar, Eigen::Dynamic, 1> err;
+    rotError(X1, X2, err);
+    return err.mean();
+}
+
+#endif
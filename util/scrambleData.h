@@ -1,11 +1,17 @@
 /*
 DESCRIPTION:
 
-The program defines a function scrambleData that takes a 3D Eigen::MatrixXd M 
-as input along with a scrambling rate s_rate. It then generates a random 
-permutation of the third dimension of M with a probability proportional to 
-s_rate and returns a partially permuted copy of M as output. The program 
-uses the C++ standard library chrono and random to generate the random permutation.
+The program defines a function scrambleData that takes a vector of
+matrices M as input along with a scrambling rate s_rate in percent. Each
+entry is swapped with a random entry with probability s_rate / 100, and
+the partially permuted copy of M is returned. The random draws come from
+the RngStream rng (rng.h), so the same stream gives the same permutation;
+the overload with an index keeps the original signature, ignores the
+index as before and draws from defaultRngStream().
+
+scrambleView draws the same permutation as scrambleData but returns a
+PermutedPoses view of M instead of a permuted copy, and
+scramblePermutation returns only the permuted indices.
 */
 
 #ifndef SCRAMBLEDATA_H
@@ -13,27 +19,41 @@ uses the C++ standard library chrono and random to generate the random permutati
 
 #include <iostream>
 #include <eigen3/Eigen/Dense>
-#include <random>
 #include <algorithm>
-#include <chrono>
-
-std::default_random_engine generator(std::chrono::system_clock::now().time_since_epoch().count());
-std::uniform_real_distribution<double> distribution(0.0, 1.0);
+#include <vector>
+#include "rng.h"
+#include "permutedPoses.h"
 
-std::vector<Eigen::Matrix4d> scrambleData(const std::vector<Eigen::Matrix4d>& M,
-                                          int index,
-                                          double s_rate) {
-    int n = M.size();
+// Scrambled order of n entries
+std::vector<int> scramblePermutation(int n,
+                                     double s_rate,
+                                     RngStream& rng) {
     std::vector<int> M_index(n);
     for (int i = 0; i < n; i++) {
         M_index[i] = i;
     }
     for (int i = 0; i < n; i++) {
-        if (distribution(generator) <= 0.01 * s_rate) {
-            int rand_index = rand() % n;
+        if (rng.uniform() <= 0.01 * s_rate) {
+            int rand_index = rng.uniformInt(n);
             std::swap(M_index[i], M_index[rand_index]);
         }
     }
+    return M_index;
+}
+
+// Scrambled view of M, without copying the poses
+template <typename Sequence>
+PermutedPoses<Sequence> scrambleView(const Sequence& M,
+                                     double s_rate,
+                                     RngStream& rng) {
+    return PermutedPoses<Sequence>(M, scramblePermutation(M.size(), s_rate, rng));
+}
+
+std::vector<Eigen::Matrix4d> scrambleData(const std::vector<Eigen::Matrix4d>& M,
+                                          double s_rate,
+                                          RngStream& rng) {
+    int n = M.size();
+    std::vector<int> M_index = scramblePermutation(n, s_rate, rng);
     std::vector<Eigen::Matrix4d> M_perm(n);
     for (int i = 0; i < n; i++) {
         M_perm[i] = M[M_index[i]];
@@ -41,5 +61,11 @@ std::vector<Eigen::Matrix4d> scrambleData(const std::vector<Eigen::Matrix4d>& M,
     return M_perm;
 }
 
+std::vector<Eigen::Matrix4d> scrambleData(const std::vector<Eigen::Matrix4d>& M,
+                                          int /*index*/,
+                                          double s_rate) {
+    return scrambleData(M, s_rate, defaultRngStream());
+}
+
 
 #endif
\ No newline at end of file
@@ -0,0 +1,139 @@
+/*
+DESCRIPTION:
+
+The program defines closed-form exponential and logarithm maps for the
+rotation group SO(3) and the rigid body group SE(3). They replace the
+general dense matrix functions from unsupported/Eigen/MatrixFunctions
+(Schur / Pade based .exp() and .log()) wherever the argument is known to
+be a rotation or a rigid transformation.
+
+so3Exp uses the Rodrigues formula R = I + A*W + B*W^2 and so3Log inverts
+it from the trace and the skew-symmetric part of R. Near theta = pi the
+skew part vanishes, so the axis is recovered from the symmetric part
+of R instead. se3Exp and se3Log additionally use the closed-form
+V matrix (left Jacobian of SO(3)) and its inverse to map the
+translational part. Taylor expansions are used for small angles.
+
+Twists follow the same ordering as se3Vec: xi = [w; v], where w is the
+rotational and v the translational part. All four maps keep the scalar
+type of their argument (float or double).
+
+Input:
+    so3Exp: w - Vector dim 3x1
+    so3Log: R - Matrix dim 3x3
+    se3Exp: xi - Vector dim 6x1
+    se3Log: X - Matrix dim 4x4
+Output:
+    so3Exp: Matrix dim 3x3
+    so3Log: Vector dim 3x1
+    se3Exp: Matrix dim 4x4
+    se3Log: Vector dim 6x1
+*/
+
+#ifndef SE3EXPLOG_H
+#define SE3EXPLOG_H
+
+#include <cmath>
+#include <eigen3/Eigen/Dense>
+#include "so3Vec.h"
+
+template <typename Derived>
+inline Eigen::Matrix<typename Derived::Scalar, 3, 3> so3Exp(const Eigen::MatrixBase<Derived>& w_in) {
+    typedef typename Derived::Scalar Scalar;
+    const Eigen::Matrix<Scalar, 3, 1> w = w_in;
+    Scalar theta2 = w.squaredNorm();
+    Scalar theta = std::sqrt(theta2);
+    Scalar A, B;
+    if (theta < Scalar(1e-4)) {
+        A = 1 - theta2 / 6;
+        B = Scalar(0.5) - theta2 / 24;
+    } else {
+        A = std::sin(theta) / theta;
+        B = (1 - std::cos(theta)) / theta2;
+    }
+    Eigen::Matrix<Scalar, 3, 3> W = skew(w);
+    return Eigen::Matrix<Scalar, 3, 3>::Identity() + A * W + B * W * W;
+}
+
+template <typename Derived>
+inline Eigen::Matrix<typename Derived::Scalar, 3, 1> so3Log(const Eigen::MatrixBase<Derived>& R_in) {
+    typedef typename Derived::Scalar Scalar;
+    const Eigen::Matrix<Scalar, 3, 3> R = R_in;
+
+    // 2*sin(theta)*axis
+    Eigen::Matrix<Scalar, 3, 1> s(R(2, 1) - R(1, 2), R(0, 2) - R(2, 0), R(1, 0) - R(0, 1));
+    Scalar cos_theta = Scalar(0.5) * (R.trace() - 1);
+    Scalar theta = std::atan2(Scalar(0.5) * s.norm(), cos_theta);
+
+    if (theta < Scalar(1e-4)) {
+        return (Scalar(0.5) + theta * theta / 12) * s;
+    }
+
+    if (cos_theta < Scalar(-0.99)) {
+        // (R + R^T)/2 - cos(theta)*I = (1 - cos(theta)) * axis * axis^T
+        Eigen::Matrix<Scalar, 3, 3> S = Scalar(0.5) * (R + R.transpose());
+        S.diagonal().array() -= cos_theta;
+        int k;
+        S.diagonal().maxCoeff(&k);
+        Eigen::Matrix<Scalar, 3, 1> axis = S.col(k) / std::sqrt(S(k, k) * (1 - cos_theta));
+        if (axis.dot(s) < 0) {
+            axis = -axis;
+        }
+        return theta * axis;
+    }
+
+    return theta / (2 * std::sin(theta)) * s;
+}
+
+template <typename Derived>
+inline Eigen::Matrix<typename Derived::Scalar, 4, 4> se3Exp(const Eigen::MatrixBase<Derived>& xi_in) {
+    typedef typename Derived::Scalar Scalar;
+    const Eigen::Matrix<Scalar, 6, 1> xi = xi_in;
+    Eigen::Matrix<Scalar, 3, 1> w = xi.template head<3>();
+    Scalar theta2 = w.squaredNorm();
+    Scalar theta = std::sqrt(theta2);
+    Scalar A, B, C;
+    if (theta < Scalar(1e-4)) {
+        A = 1 - theta2 / 6;
+        B = Scalar(0.5) - theta2 / 24;
+        C = Scalar(1) / 6 - theta2 / 120;
+    } else {
+        Scalar sin_theta = std::sin(theta);
+        A = sin_theta / theta;
+        B = (1 - std::cos(theta)) / theta2;
+        C = (theta - sin_theta) / (theta2 * theta);
+    }
+    Eigen::Matrix<Scalar, 3, 3> W = skew(w);
+    Eigen::Matrix<Scalar, 3, 3> W2 = W * W;
+
+    Eigen::Matrix<Scalar, 4, 4> X = Eigen::Matrix<Scalar, 4, 4>::Identity();
+    X.template block<3, 3>(0, 0) += A * W + B * W2;
+    X.template block<3, 1>(0, 3) = (Eigen::Matrix<Scalar, 3, 3>::Identity() + B * W + C * W2) * xi.template tail<3>();
+    return X;
+}
+
+template <typename Derived>
+inline Eigen::Matrix<typename Derived::Scalar, 6, 1> se3Log(const Eigen::MatrixBase<Derived>& X_in) {
+    typedef typename Derived::Scalar Scalar;
+    const Eigen::Matrix<Scalar, 4, 4> X = X_in;
+    Eigen::Matrix<Scalar, 3, 1> w = so3Log(X.template block<3, 3>(0, 0));
+    Scalar theta2 = w.squaredNorm();
+    Scalar theta = std::sqrt(theta2);
+
+    // V^{-1} = I - W/2 + D*W^2
+    Scalar D;
+    if (theta < Scalar(1e-4)) {
+        D = Scalar(1) / 12 + theta2 / 720;
+    } else {
+        Scalar half = Scalar(0.5) * theta;
+        D = (1 - half * std::cos(half) / std::sin(half)) / theta2;
+    }
+    Eigen::Matrix<Scalar, 3, 3> W = skew(w);
+    Eigen::Matrix<Scalar, 3, 3> Vinv = Eigen::Matrix<Scalar, 3, 3>::Identity() - Scalar(0.5) * W + D * W * W;
+
+    Eigen::Matrix<Scalar, 6, 1> xi;
+    xi << w, Vinv * X.template block<3, 1>(0, 3);
+    return xi;
+}
+
+#endif
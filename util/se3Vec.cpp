@@ -10,31 +10,16 @@ and returns the corresponding vector. Otherwise, if the input is a vector,
 the function computes and returns the corresponding skew-symmetric matrix. 
 The output vector or matrix is represented by an Eigen object of type 
 "Eigen::Matrix<double, 6, 1>".
+
+Fixed-size overloads are selected at compile time for 6x1 vectors
+(returning a Matrix4d) and 4x4 matrices (returning a 6x1 vector). Unlike
+the MatrixXd version they do not branch at run time or allocate.
 */
 
 #include <iostream>
-#include <eigen3/Eigen/Core>
+#include "se3Vec.h"
 
-Eigen::MatrixXd se3Vec(const Eigen::MatrixXd& X)
-{
-    if (X.cols() == 4) // If input is skew-sym change to vector
-    {
-        Eigen::Matrix<double, 6, 1> g;
-        g << -X(1,2), X(0,2), -X(0,1), X(0,3), X(1,3), X(2,3);
-        return g;
-    } 
-    else // If input is vector change to skew-sym
-    {
-        Eigen::Matrix4d g;
-        g << 0, -X(2), X(1), X(3), 
-            X(2), 0, -X(0), X(4), 
-            -X(1), X(0), 0, X(5), 
-            0, 0, 0, 0;
-        return g;
-    }
-} 
-
- int main()
+int main()
 {
     Eigen::Matrix<double, 4, 4> M;
     M << 0, -3, 2, 4,
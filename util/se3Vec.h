@@ -10,12 +10,17 @@ and returns the corresponding vector. Otherwise, if the input is a vector,
 the function computes and returns the corresponding skew-symmetric matrix. 
 The output vector or matrix is represented by an Eigen object of type 
 "Eigen::Matrix<double, 6, 1>".
+
+Fixed-size overloads are selected at compile time for 6x1 vectors
+(returning a Matrix4d) and 4x4 matrices (returning a 6x1 vector). Unlike
+the MatrixXd version they do not branch at run time or allocate.
 */
 
 #ifndef SE3VEC_H
 #define SE3VEC_H
 
 #include <iostream>
+#include <type_traits>
 #include <eigen3/Eigen/Core>
 
 Eigen::MatrixXd se3Vec(const Eigen::MatrixXd& X)
@@ -37,4 +42,29 @@ Eigen::MatrixXd se3Vec(const Eigen::MatrixXd& X)
     }
 }
 
+// Vector to skew-sym, 6x1 -> Matrix4d
+template <typename Derived>
+inline typename std::enable_if<Derived::RowsAtCompileTime == 6 && Derived::ColsAtCompileTime == 1,
+                               Eigen::Matrix4d>::type
+se3Vec(const Eigen::MatrixBase<Derived>& X)
+{
+    Eigen::Matrix4d g;
+    g << 0, -X(2), X(1), X(3),
+            X(2), 0, -X(0), X(4),
+            -X(1), X(0), 0, X(5),
+            0, 0, 0, 0;
+    return g;
+}
+
+// Skew-sym to vector, Matrix4d -> 6x1
+template <typename Derived>
+inline typename std::enable_if<Derived::RowsAtCompileTime == 4 && Derived::ColsAtCompileTime == 4,
+                               Eigen::Matrix<double, 6, 1>>::type
+se3Vec(const Eigen::MatrixBase<Derived>& X)
+{
+    Eigen::Matrix<double, 6, 1> g;
+    g << -X(1,2), X(0,2), -X(0,1), X(0,3), X(1,3), X(2,3);
+    return g;
+}
+
 #endif
\ No newline at end of file
@@ -24,6 +24,9 @@ The function returns the input matrices with the applied noise as a vector of ma
 New argument - length of the matrix array
 
 ONLY CASE 1 - WORKS - at the moment
+
+The random draws come from rng (rng.h), or from defaultRngStream() when
+it is omitted.
 */
 
 #ifndef SENSORNOISE_H
@@ -38,24 +41,28 @@ ONLY CASE 1 - WORKS - at the moment
 #include <random>
 #include "se3Vec.h"
 #include "so3Vec.h"
+#include "rng.h"
 
 Eigen::Matrix4d* sensorNoise(const Eigen::Matrix4d* g,
                              int len,
                              const Eigen::MatrixXd gmean,
                              double sd,
-                             int model){
+                             int model,
+                             RngStream& rng){
     // Declare g_noise as an array of matrices and allocate memory for it
     Eigen::Matrix4d *g_noise = new Eigen::Matrix4d[len];
 
     switch (model) {
         case 1: {
-            Eigen::Vector3d temp = Eigen::Vector3d::Random();
-            Eigen::VectorXd noise_old1(6);
-            Eigen::VectorXd noise_old2(6);
+            Eigen::Vector3d temp, trans;
+            fillUniform(temp, rng);
+            fillUniform(trans, rng);
+            Eigen::Matrix<double, 6, 1> noise_old1;
+            Eigen::Matrix<double, 6, 1> noise_old2;
 
             // Independently from Normal Distribution
             noise_old1.segment(0, 3) = Eigen::Vector3d::Zero();
-            noise_old1.segment(3, 3) = sd * Eigen::Vector3d::Random();
+            noise_old1.segment(3, 3) = sd * trans;
             noise_old1 += gmean;
 
             noise_old2.segment(0, 3) = sd * temp.normalized() * temp.norm();
@@ -144,4 +151,12 @@ Eigen::Matrix4d* sensorNoise(const Eigen::Matrix4d* g,
     return g_noise;
 }
 
+Eigen::Matrix4d* sensorNoise(const Eigen::Matrix4d* g,
+                             int len,
+                             const Eigen::MatrixXd gmean,
+                             double sd,
+                             int model){
+    return sensorNoise(g, len, gmean, sd, model, defaultRngStream());
+}
+
 #endif
\ No newline at end of file
@@ -7,28 +7,18 @@ converts it to a skew-symmetric matrix, and if the input is a skew-symmetric
 matrix, the function returns it directly. The resulting 3x3 matrix represents 
 an element of the special orthogonal group SO(3), which is used in 3D 
 rotation calculations.
+
+Besides the MatrixXd version, which branches on the number of columns at
+run time and allocates its result on the heap, the header provides
+fixed-size overloads selected at compile time: a 3x1 vector maps to a
+Matrix3d and a 3x3 matrix maps to a Vector3d. They never allocate and
+should be preferred in solver loops. skew() is the vector to
+skew-symmetric matrix direction of the same map and is shared by
+skewExp and the solvers.
 */
 
 #include <iostream>
-#include <eigen3/Eigen/Core>
-
-Eigen::MatrixXd so3Vec(const Eigen::MatrixXd& X)
-{
-    if (X.cols() == 3) // If input is skew-sym change to vector
-    {
-        Eigen::Matrix<double, 3, 1> g;
-        g << -X(1,2), X(0,2), -X(0,1);
-        return g;
-    }
-    else // If input is vector change to skew-sym
-    {
-        Eigen::Matrix3d g;
-        g << 0, -X(2), X(1),
-            X(2), 0, -X(0),
-            -X(1), X(0), 0;
-        return g;
-    }
-}
+#include "so3Vec.h"
 
 int main()
 {
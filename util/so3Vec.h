@@ -7,11 +7,21 @@ converts it to a skew-symmetric matrix, and if the input is a skew-symmetric
 matrix, the function returns it directly. The resulting 3x3 matrix represents 
 an element of the special orthogonal group SO(3), which is used in 3D 
 rotation calculations.
+
+Besides the MatrixXd version, which branches on the number of columns at
+run time and allocates its result on the heap, the header provides
+fixed-size overloads selected at compile time: a 3x1 vector maps to a
+Matrix3d and a 3x3 matrix maps to a Vector3d. They never allocate and
+should be preferred in solver loops. skew() is the vector to
+skew-symmetric matrix direction of the same map and is shared by
+skewExp and the solvers. The fixed-size overloads and skew() keep the
+scalar type of their argument, so they work for float as well as double.
 */
 
 #ifndef SO3VEC_H
 #define SO3VEC_H
 
+#include <type_traits>
 #include <eigen3/Eigen/Core>
 
 Eigen::MatrixXd so3Vec(const Eigen::MatrixXd& X)
@@ -32,4 +42,32 @@ Eigen::MatrixXd so3Vec(const Eigen::MatrixXd& X)
     }
 }
 
+// Vector to skew-sym, Vector3d -> Matrix3d
+template <typename Derived>
+inline typename std::enable_if<Derived::RowsAtCompileTime == 3 && Derived::ColsAtCompileTime == 1,
+                               Eigen::Matrix<typename Derived::Scalar, 3, 3>>::type
+so3Vec(const Eigen::MatrixBase<Derived>& X)
+{
+    Eigen::Matrix<typename Derived::Scalar, 3, 3> g;
+    g << 0, -X(2), X(1),
+            X(2), 0, -X(0),
+            -X(1), X(0), 0;
+    return g;
+}
+
+// Skew-sym to vector, Matrix3d -> Vector3d
+template <typename Derived>
+inline typename std::enable_if<Derived::RowsAtCompileTime == 3 && Derived::ColsAtCompileTime == 3,
+                               Eigen::Matrix<typename Derived::Scalar, 3, 1>>::type
+so3Vec(const Eigen::MatrixBase<Derived>& X)
+{
+    return Eigen::Matrix<typename Derived::Scalar, 3, 1>(-X(1,2), X(0,2), -X(0,1));
+}
+
+template <typename Derived>
+inline Eigen::Matrix<typename Derived::Scalar, 3, 3> skew(const Eigen::MatrixBase<Derived>& v)
+{
+    return so3Vec(v.template head<3>());
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,187 @@
+/*
+DESCRIPTION:
+
+The program defines SweepCheckpoint, an append-only binary file of the
+finished cells of a Monte Carlo sweep, so that a sweep interrupted by a
+crash or a preemption resumes where it stopped.
+
+Each record holds the configuration hash, the seed, the trial and rate
+indices of one cell and the values the cell produced, followed by a
+checksum. A record is written and flushed as soon as its cell finishes.
+Cells are keyed by (configuration hash, seed, trial, rate): on opening,
+the records of the same configuration and seed are loaded and the other
+records are kept but ignored, so one file can hold several studies. A
+record cut short by a crash fails its checksum; it and everything after
+it are dropped from the file before new records are appended.
+
+ConfigHash is a 64 bit FNV-1a hash of the parameters that change the
+results of a cell (rates, data size, covariances, options), not of the
+number of trials, so a sweep can later be extended with more trials.
+
+Input:
+    path: checkpoint file, created if missing
+    config_hash: ConfigHash of the sweep parameters
+    seed: seed of the sweep
+Output:
+    find(trial, rate, values): values of a finished cell
+*/
+
+#ifndef SWEEPCHECKPOINT_H
+#define SWEEPCHECKPOINT_H
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+class ConfigHash {
+public:
+    ConfigHash &add(const void *data, size_t bytes) {
+        const unsigned char *p = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < bytes; ++i) {
+            hash_ = (hash_ ^ p[i]) * 0x100000001B3ULL;
+        }
+        return *this;
+    }
+
+    ConfigHash &add(int x) {
+        return add(&x, sizeof(x));
+    }
+
+    ConfigHash &add(double x) {
+        return add(&x, sizeof(x));
+    }
+
+    ConfigHash &add(const std::string &x) {
+        add(static_cast<int>(x.size()));
+        return add(x.data(), x.size());
+    }
+
+    template <typename T>
+    ConfigHash &add(const std::vector<T> &x) {
+        add(static_cast<int>(x.size()));
+        for (const T &v : x) {
+            add(v);
+        }
+        return *this;
+    }
+
+    uint64_t value() const {
+        return hash_;
+    }
+
+private:
+    uint64_t hash_ = 0xCBF29CE484222325ULL;
+};
+
+class SweepCheckpoint {
+public:
+    SweepCheckpoint(const std::string &path, uint64_t config_hash, uint64_t seed)
+        : path_(path), config_hash_(config_hash), seed_(seed) {
+        load();
+        file_.open(path_, std::ios::binary | std::ios::app);
+        if (!file_) {
+            std::cerr << "Cannot open checkpoint file " << path_ << std::endl;
+        }
+    }
+
+    uint64_t seed() const {
+        return seed_;
+    }
+
+    // Number of finished cells of this configuration and seed
+    int size() const {
+        return cells_.size();
+    }
+
+    bool find(int trial, int rate, std::vector<double> &values) const {
+        auto it = cells_.find(std::make_pair(trial, rate));
+        if (it == cells_.end()) {
+            return false;
+        }
+        values = it->second;
+        return true;
+    }
+
+    // Append a finished cell and flush it, may be called from any thread
+    void append(int trial, int rate, const std::vector<double> &values) {
+        Header h = {kMagic, config_hash_, seed_, trial, rate, static_cast<int>(values.size())};
+        uint64_t check = checksum(h, values.data());
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        cells_[std::make_pair(trial, rate)] = values;
+        file_.write(reinterpret_cast<const char *>(&h), sizeof(h));
+        file_.write(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(double));
+        file_.write(reinterpret_cast<const char *>(&check), sizeof(check));
+        file_.flush();
+    }
+
+private:
+    static constexpr uint32_t kMagic = 0x4B435753; // "SWCK"
+
+    struct Header {
+        uint32_t magic;
+        uint64_t config_hash;
+        uint64_t seed;
+        int32_t trial;
+        int32_t rate;
+        int32_t count;
+    };
+
+    static uint64_t checksum(const Header &h, const double *values) {
+        ConfigHash c;
+        c.add(&h, sizeof(h));
+        c.add(values, h.count * sizeof(double));
+        return c.value();
+    }
+
+    // Read the valid records and cut off a torn last record
+    void load() {
+        std::ifstream in(path_, std::ios::binary);
+        if (!in) {
+            return;
+        }
+
+        std::streamoff valid_end = 0;
+        Header h;
+        std::vector<double> values;
+        uint64_t check;
+        while (in.read(reinterpret_cast<char *>(&h), sizeof(h))) {
+            if (h.magic != kMagic || h.count < 0 || h.count > (1 << 20)) {
+                break;
+            }
+            values.resize(h.count);
+            if (!in.read(reinterpret_cast<char *>(values.data()), h.count * sizeof(double))
+                || !in.read(reinterpret_cast<char *>(&check), sizeof(check))
+                || check != checksum(h, values.data())) {
+                break;
+            }
+            valid_end = in.tellg();
+            if (h.config_hash == config_hash_ && h.seed == seed_) {
+                cells_[std::make_pair(h.trial, h.rate)] = values;
+            }
+        }
+        in.close();
+
+        std::error_code ec;
+        if (std::filesystem::file_size(path_, ec) != static_cast<uintmax_t>(valid_end) && !ec) {
+            std::cerr << "Dropping an incomplete record at the end of " << path_ << std::endl;
+            std::filesystem::resize_file(path_, valid_end, ec);
+        }
+    }
+
+    std::string path_;
+    uint64_t config_hash_;
+    uint64_t seed_;
+    std::map<std::pair<int, int>, std::vector<double>> cells_;
+    std::ofstream file_;
+    std::mutex mutex_;
+};
+
+#endif
@@ -0,0 +1,118 @@
+/*
+DESCRIPTION:
+
+The program defines a small fixed-size thread pool used by the parallel
+helpers. The pool starts num_threads workers once and reuses them.
+submit() queues a callable and returns a std::future for its result.
+parallelSum() splits the index range [0, N) into at most size()
+contiguous chunks of at least grain_size elements and sums the partial
+results in chunk order. The chunk boundaries depend only on N, the
+grain size and the pool size, so for a fixed thread count the result
+is bit-reproducible. Ranges smaller than two grains are summed on the
+calling thread.
+
+Tasks must not block waiting on other tasks of the same pool.
+*/
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    explicit ThreadPool(int num_threads = std::thread::hardware_concurrency())
+        : stop_(false) {
+        num_threads = std::max(1, num_threads);
+        for (int i = 0; i < num_threads; ++i) {
+            workers_.emplace_back([this] { worker(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& t : workers_) {
+            t.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <typename F>
+    auto submit(F f) -> std::future<decltype(f())> {
+        using R = decltype(f());
+        auto task = std::make_shared<std::packaged_task<R()>>(std::move(f));
+        std::future<R> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.emplace([task] { (*task)(); });
+        }
+        cv_.notify_one();
+        return result;
+    }
+
+    int size() const {
+        return workers_.size();
+    }
+
+private:
+    void worker() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+                if (stop_ && tasks_.empty()) {
+                    return;
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_;
+};
+
+// Sum f(begin, end) over contiguous chunks of [0, N)
+template <typename T, typename F>
+T parallelSum(ThreadPool& pool, int N, int grain_size, const T& zero, F f) {
+    int num_chunks = std::min(pool.size(), N / std::max(1, grain_size));
+    if (num_chunks <= 1) {
+        return f(0, N);
+    }
+
+    std::vector<std::future<T>> parts;
+    parts.reserve(num_chunks);
+    for (int c = 0; c < num_chunks; ++c) {
+        int begin = static_cast<long long>(N) * c / num_chunks;
+        int end = static_cast<long long>(N) * (c + 1) / num_chunks;
+        parts.push_back(pool.submit([&f, begin, end] { return f(begin, end); }));
+    }
+
+    T sum = zero;
+    for (auto& part : parts) {
+        sum += part.get();
+    }
+    return sum;
+}
+
+#endif
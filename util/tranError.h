@@ -12,21 +12,64 @@ The difference between these two vectors is then computed using
 the norm function, which calculates the Euclidean norm of the 
 resulting 3x1 vector.
 
-The function then returns the computed translation error as a double value.
+The function then returns the computed translation error in the scalar
+type of its inputs (float or double).
+The PoseArray overloads compute the errors of many pairs at once and
+return either every error or their mean.
 */
 
 #ifndef TRANERROR_H
 #define TRANERROR_H
 
 #include <iostream>
+#include <algorithm>
 #include <eigen3/Eigen/Dense>
+#include "poseArray.h"
 
-double tranError(const Eigen::Matrix4d& X1,
-                 const Eigen::Matrix4d& X2) {
-    Eigen::Vector3d p1 = X1.block<3,1>(0,3);
-    Eigen::Vector3d p2 = X2.block<3,1>(0,3);
+template <typename Derived1, typename Derived2>
+typename Derived1::Scalar tranError(const Eigen::MatrixBase<Derived1>& X1,
+                                    const Eigen::MatrixBase<Derived2>& X2) {
+    typedef typename Derived1::Scalar Scalar;
+    Eigen::Matrix<Scalar, 3, 1> p1 = X1.template block<3,1>(0,3);
+    Eigen::Matrix<Scalar, 3, 1> p2 = X2.template block<3,1>(0,3);
 
     return (p1 - p2).norm();
 }
 
-#endif
\ No newline at end of file
+// Translation errors of a chunk of pairs
+template <typename Scalar>
+inline void tranError(const PoseChunk<Scalar> &X1,
+                      const PoseChunk<Scalar> &X2,
+                      typename PoseChunk<Scalar>::Array &err) {
+    err = ((X1.t[0] - X2.t[0]).square() + (X1.t[1] - X2.t[1]).square()
+           + (X1.t[2] - X2.t[2]).square()).sqrt();
+}
+
+// Translation error of every pair X1[i], X2[i]
+template <typename Scalar>
+void tranError(const PoseArrayT<Scalar> &X1,
+               const PoseArrayT<Scalar> &X2,
+               Eigen::Matrix<Scalar, Eigen::Dynamic, 1> &err) {
+    typedef PoseArrayT<Scalar> Poses;
+    typename Poses::ChunkPose P, Q;
+    typename Poses::ChunkArray e;
+    err.resize(X1.size());
+    for (int j = 0; j < X1.chunks(); ++j) {
+        X1.load(j, P);
+        X2.load(j, Q);
+        tranError(P, Q, e);
+        int n = std::min(Poses::Chunk, X1.size() - Poses::Chunk * j);
+        err.segment(Poses::Chunk * j, n) = e.head(n).matrix();
+    }
+}
+
+// Mean translation error over all pairs
+template <typename Scalar>
+Scalar tranError(const PoseArrayT<Scalar> &X1,
+                 const PoseArrayT<Scalar> &X2) {
+    Eigen::Matrix<Scalar, Eigen::Dynamic, 1> err;
+    tranError(X1, X2, err);
+    return err.mean();
+}
+
+#endif